@@ -0,0 +1,22 @@
+# Converts a binary file into a C++ source file that defines it as a byte array.
+# Usage: cmake -DINPUT=<file> -DOUTPUT=<source> -DSYMBOL=<name> -P embed_file.cmake
+# Defines `const unsigned char <name>[]` and `const std::size_t <name>Size`.
+
+file(READ "${INPUT}" content HEX)
+string(LENGTH "${content}" hexLength)
+math(EXPR size "${hexLength} / 2")
+
+string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${content}")
+# Break lines every 16 bytes (CMake regexes have no {n} repetition)
+set(linePattern "")
+foreach(i RANGE 15)
+    string(APPEND linePattern "0x[0-9a-f][0-9a-f],")
+endforeach()
+string(REGEX REPLACE "(${linePattern})" "\\1\n" bytes "${bytes}")
+
+file(WRITE "${OUTPUT}.tmp"
+    "// Generated from ${INPUT} by embed_file.cmake, do not edit\n"
+    "#include <cstddef>\n\n"
+    "extern const unsigned char ${SYMBOL}[] = {\n${bytes}\n};\n"
+    "extern const std::size_t ${SYMBOL}Size = ${size};\n")
+file(RENAME "${OUTPUT}.tmp" "${OUTPUT}")
@@ -0,0 +1,20 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This header declares the computer player. `computerMove` picks the engine for the game's variant
+and difficulty, so the game, the tournament runner and other tools all play the same way.
+*/
+
+#ifndef AI_HPP
+#define AI_HPP
+
+#include "game.hpp"
+
+extern bool logEngineStats; // print search statistics after each computer move
+
+pair<int, int> randomMove(const Game &game);
+pair<int, int> computerMove(const Game &game, PLAYER computer);
+
+#endif
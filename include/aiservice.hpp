@@ -0,0 +1,102 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This header declares the AI service, which chooses computer moves for many games hosted in one
+process. Requests for positions that are the same up to a symmetry of the board share one search:
+a repeat is answered from a shared result cache, and a request for a position already being
+searched waits for that search. The remaining positions are searched by a fixed pool of worker
+threads, most urgent deadline first, and a request whose deadline passes is answered at once with
+a quick move from a low level of the strength ladder.
+*/
+
+#ifndef AISERVICE_HPP
+#define AISERVICE_HPP
+
+#include "game.hpp"
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+using namespace std;
+
+const int FALLBACK_STRENGTH_LEVEL = 3; // ladder level of the move given when a deadline passes
+
+struct AiReply
+{
+    pair<int, int> move = {-1, -1};
+    bool cached = false; // answered from the result cache
+    bool coalesced = false; // shared the search of a request made earlier
+    bool fallback = false; // the deadline passed (or the queue was full) before a search finished
+};
+
+struct AiServiceStats
+{
+    uint64_t requests = 0;
+    uint64_t searches = 0; // positions actually searched
+    uint64_t cacheHits = 0;
+    uint64_t coalesced = 0;
+    uint64_t fallbacks = 0;
+    size_t peakQueueDepth = 0;
+};
+
+class AiService
+{
+public:
+    explicit AiService(int threads = max(1u, thread::hardware_concurrency()), size_t cacheEntries = 1 << 16,
+                       size_t queueCapacity = 4096);
+    ~AiService();
+
+    future<AiReply> requestMove(const Game &game, PLAYER computer, double deadlineSeconds);
+    AiServiceStats stats() const;
+
+private:
+    struct Waiter
+    {
+        promise<AiReply> reply;
+        Game game; // the requester's own position, for the fallback move
+        PLAYER computer;
+        int symmetry; // maps the requester's board onto the searched one
+        uint64_t requestedAt; // microseconds
+        uint64_t deadline;
+        bool coalesced;
+    };
+
+    struct Job
+    {
+        string key; // canonical position, or empty if the request may not be shared
+        Game game; // canonical position
+        PLAYER computer;
+        uint64_t queuedAt;
+        uint64_t deadline; // earliest deadline of the waiters
+        vector<unique_ptr<Waiter>> waiters;
+    };
+
+    mutable mutex lock;
+    condition_variable jobReady; // signalled when a job is queued or the service stops
+    condition_variable deadlineChanged; // signalled when an earlier deadline is added
+    deque<shared_ptr<Job>> queue;
+    unordered_map<string, shared_ptr<Job>> inFlight; // shareable jobs queued or being searched
+    unordered_map<string, pair<int, int>> cache; // canonical position -> move on the canonical board
+    deque<string> cacheOrder; // oldest cached position first, for eviction
+    size_t cacheEntries;
+    size_t queueCapacity;
+    size_t waiting = 0; // requests not yet answered
+    AiServiceStats counters;
+    bool stopping = false;
+    vector<thread> workers;
+    thread deadlineWatcher;
+
+    void runWorker();
+    void watchDeadlines();
+    void answer(Waiter &waiter, pair<int, int> canonicalMove, bool cached);
+    void answerWithFallback(Waiter &waiter);
+    void updateGauges();
+};
+
+#endif
@@ -0,0 +1,19 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This header declares the assets compiled into the executable. The build converts
+assets/Roboto-Regular.ttf into a byte array (see cmake/embed_file.cmake), so the game starts
+without reading the font from the working directory.
+*/
+
+#ifndef ASSETS_HPP
+#define ASSETS_HPP
+
+#include <cstddef>
+
+extern const unsigned char embeddedFont[]; // contents of Roboto-Regular.ttf
+extern const std::size_t embeddedFontSize;
+
+#endif
@@ -0,0 +1,29 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This header declares the batch win detector for the classic 3x3 board. Boards are packed into
+9-bit masks (bit = row * 3 + col) and passed as separate X and O arrays (structure of arrays), so
+many boards can be classified per instruction with AVX2 or SSE2. The vector path is chosen at
+runtime from the CPU's features and always agrees with `Game::updateGameStatus`.
+*/
+
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include "game.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Classifier paths, fastest first
+const char *const BATCH_CLASSIFIERS[] = {"avx2", "sse2", "scalar"};
+
+void packBoard(const Game &game, uint16_t &xMask, uint16_t &oMask);
+void classifyBoards(const uint16_t *xMasks, const uint16_t *oMasks, uint8_t *results, size_t count);
+bool classifyBoardsWith(const string &name, const uint16_t *xMasks, const uint16_t *oMasks, uint8_t *results, size_t count);
+void classifyBoardsScalar(const uint16_t *xMasks, const uint16_t *oMasks, uint8_t *results, size_t count);
+const char *batchClassifierName();
+
+#endif
@@ -0,0 +1,53 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This header defines the `EvaluationCache` class, a transposition cache that stores minimax results
+keyed by board position. The cache can be snapshotted to disk and reloaded on the next launch so
+the computer does not have to search positions it has already solved in a previous run.
+*/
+
+#ifndef CACHE_HPP
+#define CACHE_HPP
+
+#include "types.hpp"
+#include <cstdint>
+#include <shared_mutex>
+#include <unordered_map>
+
+using namespace std;
+
+/**
+ * @brief A single cached search result.
+ *
+ * The score is stored from X's point of view so one entry serves both X and O as the computer.
+ */
+struct CacheEntry
+{
+    int score; // minimax score from X's point of view
+    int row; // row of the best move
+    int col; // column of the best move
+};
+
+class EvaluationCache
+{
+public:
+    bool lookup(uint64_t key, CacheEntry &entry) const;
+    void store(uint64_t key, const CacheEntry &entry);
+    void clear();
+    size_t size() const;
+    bool save(const string &path) const;
+    bool load(const string &path);
+
+private:
+    mutable shared_mutex lock; // readers share, writers are exclusive
+    unordered_map<uint64_t, CacheEntry> entries; // position key -> cached result
+};
+
+extern EvaluationCache evaluationCache;
+
+void loadEvaluationCache();
+void saveEvaluationCache();
+
+#endif
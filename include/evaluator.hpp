@@ -0,0 +1,76 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This header declares the pattern evaluator used by depth-limited searches on the line boards
+(classic and Gomoku). It counts, for each player, the lines still open to them by number of marks,
+the empty cells that would complete a line (threats) and the empty cells where two nearly-complete
+lines cross (forks). The counts are updated incrementally as marks are played and undone, and the
+weights that turn them into a score can be tuned from a plain-text weights file.
+*/
+
+#ifndef EVALUATOR_HPP
+#define EVALUATOR_HPP
+
+#include "lines.hpp"
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+const int MAX_PATTERN_LENGTH = 8; // longest winning line the evaluator supports
+const int PATTERN_WIN = 100000; // score of a won position, or one the side to move wins next move
+
+struct EvalWeights
+{
+    int line[MAX_PATTERN_LENGTH + 1] = {0, 1, 8, 48, 48, 48, 48, 48, 48}; // open line with n marks (n < length - 1)
+    int threat = 300; // open line one mark short of a win
+    int fork = 600; // empty cell where two lines two marks short of a win cross
+    int tempo = 120; // percentage applied to the score of the side to move
+};
+
+extern EvalWeights evalWeights; // weights used by the game, loaded from EVAL_WEIGHTS_FILE at startup
+
+bool loadEvalWeights(const string &path, EvalWeights &weights);
+
+class PatternEvaluator
+{
+public:
+    PatternEvaluator() = default;
+    explicit PatternEvaluator(const LineTable &lines, const EvalWeights &weights = evalWeights);
+
+    void reset(const LineTable &lines, const EvalWeights &weights = evalWeights);
+    void clear();
+    bool active() const { return lines != nullptr; }
+
+    void play(int cell, int player);
+    void undo(int cell, int player);
+    void setBoard(const vector<vector<int>> &grid);
+
+    int evaluate(int toMove) const;
+    int playerScore(int player) const;
+    int openLines(int player, int marks) const { return open[player][marks]; }
+    int threats(int player) const { return winningCells[player]; }
+    int forks(int player) const { return forkCells[player]; }
+    bool hasWon(int player) const { return open[player][length] > 0; }
+
+private:
+    const LineTable *lines = nullptr;
+    const EvalWeights *weights = nullptr;
+    int length = 0;
+    vector<int8_t> cells; // 0 empty, 1 X, 2 O
+    vector<uint8_t> count[2]; // marks of each player in each line
+    vector<uint8_t> nearWin[2]; // open lines one mark short of a win through each cell
+    vector<uint8_t> nearFork[2]; // open lines two marks short of a win through each cell
+    int open[2][MAX_PATTERN_LENGTH + 1] = {}; // open lines of each player by number of marks
+    int winningCells[2] = {}; // empty cells that would complete a line
+    int forkCells[2] = {}; // empty cells where two lines two marks short of a win cross
+
+    void rescore();
+    void applyLine(int line, int delta);
+    void adjustCells(vector<uint8_t> &counter, int line, int delta, int &tally, int threshold);
+    void setCellEmpty(int cell, bool empty);
+};
+
+#endif
@@ -1,41 +1,58 @@
 /*
 Author: Arina Shah
 Class: ECE4122 (A)
-Last Date Modified: 12/3/2024
+Last Date Modified: 10/19/2026
 Description:
 This header defines the `Game` class, which encapsulates the state and logic of the Tic Tac Toe game.
-It includes member variables for the grid, player turn, game status, mode, and difficulty, as well
-as functions for updating the game state, handling player moves, and managing AI functionality.
+It includes member variables for the grid, player turn, game status, mode, difficulty, and board
+variant, as well as functions for updating the game state, handling player moves, and managing AI functionality.
 */
 
 #ifndef GAME_HPP
 #define GAME_HPP
 
-#include "globals.hpp"
+#include "evaluator.hpp"
+#include "types.hpp"
+#include "lines.hpp"
+#include <cstdint>
 #include <sstream>
 
 using namespace std;
 
+const int BOARD_MASK_WORDS = 4; // 64-bit words in a cell bitmask, enough for boards of up to 256 cells
+static_assert(gomokuSize * gomokuSize <= 64 * BOARD_MASK_WORDS, "cell bitmask too small for the Gomoku board");
+
 class Game
 {
 public:
-    vector<vector<int>> grid = vector<vector<int>>(3, vector<int>(3, 0)); // game grid represented as a 3x3 matrix
+    vector<vector<int>> grid; // game grid represented as a rows x cols matrix
     PLAYER activeTurn; // player whose turn is currently active
     GAMESTATUS status; // current status of the game
     GAMEMODE mode; // selected game mode
     DIFFICULTY difficulty; // difficulty if in single player mode
+    VARIANT variant; // board variant being played
+    int rows; // number of rows on the board
+    int cols; // number of columns on the board
+    int winLength; // marks in a row needed to win
+    const LineTable *lines; // winning lines for this board shape
+    pair<int, int> lastMove; // most recent move, {-1, -1} before the first move
+    uint64_t emptyCells[BOARD_MASK_WORDS]; // bit (row * cols + col) is set while that cell is empty
+    PatternEvaluator evaluator; // pattern counts, kept up to date on the Gomoku board only
 
     /**
-     * @brief Default constructor to initialize the game state with a mode and difficulty level.
+     * @brief Default constructor to initialize the game state with a mode, difficulty level and variant.
      * @param mode The game mode (default is NO_MODE).
      * @param difficulty The difficulty level (default is DEFAULT).
+     * @param variant The board variant (default is CLASSIC).
      */
-    Game(GAMEMODE mode = NO_MODE, DIFFICULTY difficulty = DEFAULT)
+    Game(GAMEMODE mode = NO_MODE, DIFFICULTY difficulty = DEFAULT, VARIANT variant = CLASSIC)
     {
         activeTurn = X;
         status = PLAYING;
         this->mode = mode;
         this->difficulty = difficulty;
+        lastMove = {-1, -1};
+        setVariant(variant);
     }
 
     /**
@@ -49,11 +66,20 @@ public:
         this->status = oldGame.status;
         this->mode = oldGame.mode;
         this->difficulty = oldGame.difficulty;
+        this->variant = oldGame.variant;
+        this->rows = oldGame.rows;
+        this->cols = oldGame.cols;
+        this->winLength = oldGame.winLength;
+        this->lines = oldGame.lines;
+        this->lastMove = oldGame.lastMove;
         this->grid = oldGame.grid;
+        copy(begin(oldGame.emptyCells), end(oldGame.emptyCells), begin(this->emptyCells));
+        this->evaluator = oldGame.evaluator;
 
         this->playerMove(move.first, move.second); // make the move
     }
 
+    void setVariant(VARIANT variant);
     void drawBoard();
     vector<pair<int, int>> availablePositions();
     void resetGame();
@@ -61,9 +87,17 @@ public:
     void playerMove(int row, int col);
     Game getNewState(pair<int, int> move);
     int score(PLAYER player);
+    int evaluate(PLAYER player) const;
     string serialize() const;
     void deserialize(const string &data);
+    void setPosition(VARIANT variant, const vector<int> &cells, PLAYER toMove, pair<int, int> lastMove);
     bool checkEmptyCell(int row, int col);
+    bool isLegalMove(int row, int col);
+    int legalMoveMask(uint64_t mask[BOARD_MASK_WORDS]) const;
+    uint64_t key() const;
+
+private:
+    void resetEmptyCells();
 };
 
 int minimax(Game game, pair<int, int> &move, PLAYER computer);
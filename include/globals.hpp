@@ -1,14 +1,16 @@
 /*
 Author: Arina Shah
 Class: ECE4122 (A)
-Last Date Modified: 12/3/2024
+Last Date Modified: 10/19/2026
 Description:
-This header defines global constants, variables, and enums used throughout the project.
+This header defines global constants and variables used by the windowed game and the network
+code. The game rules and engines only need types.hpp, which this header includes.
 */
 
 #ifndef GLOBALS_HPP
 #define GLOBALS_HPP
 
+#include "types.hpp"
 #include <SFML/Graphics.hpp>
 #include <SFML/Network.hpp>
 #include <iostream>
@@ -26,35 +28,24 @@ const int statusBarHeight = 50;
 const unsigned short PORT = 54000;
 const std::string SERVER_IP = "127.0.0.1";
 extern TcpSocket socket;
+const unsigned short SPECTATOR_PORT = PORT + 1; // observers connect here to watch the game
+const int RESUME_TIMEOUT_SECONDS = 60; // how long a dropped session waits for the peer to come back
+const size_t RESUME_HISTORY = 32; // sent messages kept for replay after a resume
+const bool SHARED_MEMORY_TRANSPORT = true; // use a shared-memory ring instead of TCP when both players share a host
+const bool UDP_TRANSPORT = false; // use the reliable UDP transport instead of TCP between different hosts
+
+// Metrics Constants
+const std::string METRICS_FILE = "metrics.prom"; // Prometheus text dump of the metrics registry
+const int METRICS_DUMP_SECONDS = 10;
+const bool SHOW_METRICS_OVERLAY = false; // initial state of the debug overlay, toggled with F3
+
+// Tracing Constants
+const bool TRACE_ENABLED = false; // record trace spans (also enabled by setting the TICTACTOE_TRACE environment variable)
+const std::string TRACE_FILE_PREFIX = "trace"; // spans are written to trace-<pid>.json at exit
 
 // Graphics Extern Variables
 extern RenderWindow window;
 extern Font font;
 extern Text statusBarText;
 
-enum PLAYER {
-    X,
-    O,
-    NONE
-};
-
-enum GAMESTATUS {
-    X_WIN,
-    O_WIN,
-    DRAW,
-    PLAYING
-};
-
-enum GAMEMODE {
-    MULTIPLAYER,
-    SINGLE_PLAYER,
-    NO_MODE
-};
-
-enum DIFFICULTY {
-    EASY,
-    HARD,
-    DEFAULT
-};
-
 #endif
\ No newline at end of file
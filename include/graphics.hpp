@@ -1,7 +1,7 @@
 /*
 Author: Arina Shah
 Class: ECE4122 (A)
-Last Date Modified: 12/3/2024
+Last Date Modified: 10/19/2026
 Description:
 This header declares the functions used for rendering graphical elements of the game.
 */
@@ -15,9 +15,14 @@ This header declares the functions used for rendering graphical elements of the
 void displayStartScreen();
 void displayModeChoice();
 void displayDifficultyChoice();
+void displayVariantChoice();
 void gameOverScreen(GAMESTATUS gameOver, PLAYER player);
 void initStatusBar();
-void updateStatusBar(GAMEMODE mode, PLAYER activeTurn, DIFFICULTY difficulty);
+void updateStatusBar(GAMEMODE mode, PLAYER activeTurn, DIFFICULTY difficulty, VARIANT variant);
 void drawGame(Game game);
+void drawMetricsOverlay();
+void warmGlyphCache();
+
+extern bool showMetricsOverlay; // draw the metrics overlay below the status bar
 
 #endif
\ No newline at end of file
@@ -0,0 +1,30 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This header defines the `LineTable` structure, a precomputed list of every winning line (a run of
+`length` cells in a row, column or diagonal) on a rows x cols board. Win detection, the solver and
+the evaluation functions all walk the same table instead of rescanning the grid by hand.
+*/
+
+#ifndef LINES_HPP
+#define LINES_HPP
+
+#include <vector>
+
+using namespace std;
+
+struct LineTable
+{
+    int rows; // board rows
+    int cols; // board columns
+    int length; // cells in a row needed to win
+    int count; // number of lines on the board
+    vector<int> cells; // cell indices (row * cols + col) of every line, `length` per line
+    vector<vector<int>> linesByCell; // indices of the lines passing through each cell
+};
+
+const LineTable &getLineTable(int rows, int cols, int length);
+
+#endif
@@ -0,0 +1,109 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This header declares the metrics registry. Hot paths bump counters and record latencies into
+storage owned by the calling thread, so recording never contends with other threads; the
+per-thread values are only summed when a snapshot is requested. Latencies go into log-linear
+histograms (8 buckets per power of two, so any recorded value is within 12.5% of its bucket
+bound) from which percentiles are read. Gauges hold a current level, such as a queue depth, set
+by whichever thread changes it. Snapshots can be written in Prometheus text format.
+*/
+
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include "types.hpp"
+#include <cstdint>
+
+using namespace std;
+
+enum COUNTER
+{
+    MINIMAX_NODES,
+    SOLVER_NODES,
+    MCTS_PLAYOUTS,
+    QUBIC_NODES,
+    LADDER_NODES,
+    AI_MOVES,
+    NETWORK_BYTES_SENT,
+    NETWORK_BYTES_RECEIVED,
+    NETWORK_MESSAGES_SENT,
+    NETWORK_MESSAGES_RECEIVED,
+    NETWORK_RETRANSMITS,
+    FRAMES_DRAWN,
+    PREDICTION_ROLLBACKS,
+    AI_SERVICE_REQUESTS,
+    AI_SERVICE_CACHE_HITS,
+    AI_SERVICE_COALESCED,
+    AI_SERVICE_FALLBACKS,
+    COUNTER_COUNT
+};
+
+enum HISTOGRAM
+{
+    AI_THINK_TIME,
+    NETWORK_ROUND_TRIP,
+    FRAME_TIME,
+    STARTUP_TIME,
+    FIRST_FRAME_TIME,
+    INPUT_TO_PHOTON,
+    AI_SERVICE_LATENCY,
+    AI_SERVICE_QUEUE_WAIT,
+    HISTOGRAM_COUNT
+};
+
+enum GAUGE
+{
+    AI_SERVICE_QUEUE_DEPTH,
+    AI_SERVICE_WAITING,
+    GAUGE_COUNT
+};
+
+const int HISTOGRAM_BUCKETS = 496; // covers every 64-bit microsecond value
+
+struct HistogramSnapshot
+{
+    uint64_t buckets[HISTOGRAM_BUCKETS] = {}; // sample count per bucket
+    uint64_t count = 0; // samples recorded
+    uint64_t sum = 0; // total of all samples, in microseconds
+    uint64_t max = 0; // largest sample, in microseconds
+
+    uint64_t percentile(double fraction) const;
+};
+
+struct MetricsSnapshot
+{
+    uint64_t counters[COUNTER_COUNT] = {};
+    HistogramSnapshot histograms[HISTOGRAM_COUNT];
+    int64_t gauges[GAUGE_COUNT] = {};
+};
+
+/**
+ * @brief Measures the time from construction to destruction into a latency histogram.
+ */
+class ScopedLatency
+{
+public:
+    explicit ScopedLatency(HISTOGRAM histogram);
+    ~ScopedLatency();
+
+private:
+    HISTOGRAM histogram;
+    uint64_t start;
+};
+
+void countMetric(COUNTER counter, uint64_t amount = 1);
+void recordLatency(HISTOGRAM histogram, uint64_t microseconds);
+void setGauge(GAUGE gauge, int64_t value);
+uint64_t metricsClockMicros();
+int histogramBucket(uint64_t microseconds);
+uint64_t histogramBucketUpperBound(int bucket);
+MetricsSnapshot collectMetrics();
+string formatPrometheus(const MetricsSnapshot &snapshot);
+bool dumpMetrics(const string &path);
+void startMetricsDump(const string &path, int intervalSeconds);
+void stopMetricsDump();
+
+#endif
@@ -0,0 +1,85 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This header declares the exact solver for m,n,k games (k in a row on an m x n board) used by the
+distributed solver. A position is written as one character per cell (x, o or .) row by row, the
+player to move following from the marks. The solver proves the game-theoretic value (win, draw or
+loss for the player to move) with alpha-beta over a transposition table, and the opening helpers
+split a position into symmetry-distinct partitions and combine their values again.
+*/
+
+#ifndef MNK_HPP
+#define MNK_HPP
+
+#include "lines.hpp"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief m,n,k board with per-line mark counts kept up to date as moves are played and undone.
+ */
+class MnkBoard
+{
+public:
+    const LineTable *lines;
+    int rows, cols, length;
+    vector<uint8_t> cells; // 0 empty, 1 X, 2 O
+    vector<uint8_t> lineCount[2]; // marks of X (0) and O (1) in each line
+    int openLines[2] = {0, 0}; // lines not yet blocked for each player
+    int toMove = 0; // 0 for X, 1 for O
+    int empties; // number of empty cells
+    int winner = -1; // player who completed a line, -1 if none
+    uint64_t hash = 0; // zobrist hash of the marks and the player to move
+
+    MnkBoard(int rows, int cols, int length);
+
+    bool setCells(const string &text);
+    string text() const;
+    string canonicalText() const;
+    void play(int cell);
+    void undo(int cell);
+    bool over() const { return winner >= 0 || empties == 0; }
+};
+
+struct MnkSolveResult
+{
+    int value = 0; // 1 if the player to move wins, 0 for a draw, -1 if they lose
+    uint64_t nodes = 0; // positions searched
+    double seconds = 0; // wall time spent
+};
+
+/**
+ * @brief Transposition table of solved bounds, kept by a worker across the positions it solves.
+ */
+class MnkTable
+{
+public:
+    explicit MnkTable(size_t megabytes);
+
+    bool lookup(uint64_t key, int &lower, int &upper) const;
+    void store(uint64_t key, int lower, int upper, uint64_t work);
+
+private:
+    struct Entry
+    {
+        uint64_t key; // position hash, 0 if the slot is empty
+        int8_t lower; // the value is at least this
+        int8_t upper; // and at most this
+        uint64_t work; // nodes spent below this position, used for replacement
+    };
+
+    vector<Entry> entries; // buckets of two slots
+    uint64_t bucketMask; // number of buckets - 1
+};
+
+MnkSolveResult solveMnk(MnkBoard board, MnkTable &table);
+vector<string> openingPartitions(const MnkBoard &root, int plies);
+int combinePartitions(MnkBoard root, int plies, const map<string, int> &values, vector<pair<int, int>> *moveValues = nullptr);
+
+#endif
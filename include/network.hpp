@@ -1,7 +1,7 @@
 /*
 Author: Arina Shah
 Class: ECE4122 (A)
-Last Date Modified: 12/3/2024
+Last Date Modified: 10/19/2026
 Description:
 This header declares the functions for networking in multiplayer mode.
 */
@@ -11,12 +11,16 @@ This header declares the functions for networking in multiplayer mode.
 
 #include "globals.hpp"
 #include "game.hpp"
+#include "transport.hpp"
 
 void setupServer();
 void setupClient();
 void sendMove(int row, int col);
 pair<int, int> receiveMove();
 void sendGame(Game game);
+void postGame(const Game &game);
 Game receiveGame();
+Game acceptMove(const Game &authoritative, const Game &proposed);
+Game reconcileMove(const Game &predicted, const Game &confirmed, pair<int, int> move, const Game &authoritative, bool &resend);
 
 #endif
\ No newline at end of file
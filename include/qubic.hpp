@@ -0,0 +1,60 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This header defines the bitboard representation of 3D 4x4x4 Tic Tac Toe (Qubic) and declares the
+search engine for the computer player. Each player's marks fit in one 64-bit word and all 76
+winning lines are precomputed masks, so a win check is a few AND/compare operations.
+*/
+
+#ifndef QUBIC_HPP
+#define QUBIC_HPP
+
+#include "game.hpp"
+#include <atomic>
+#include <cstdint>
+
+const int QUBIC_WIN_SCORE = 100000; // search score of a win, reduced by the number of plies to reach it
+
+/**
+ * @brief Qubic position packed into one bitmask per player.
+ *
+ * Cell index is layer * 16 + row * 4 + col. On the 8x8 game grid, layer L occupies the 4x4
+ * quadrant at (L / 2, L % 2), so the four layers are drawn as a 2x2 arrangement of boards.
+ */
+struct QubicBoard
+{
+    uint64_t stones[2]; // marks of X (0) and O (1)
+    int toMove; // 0 for X, 1 for O
+    GAMESTATUS status; // outcome of the game
+
+    static QubicBoard fromGame(const Game &game);
+    void play(int cell);
+};
+
+struct QubicLimits
+{
+    double maxSeconds = 1.0; // wall time budget for one move
+    int maxDepth = 64; // iterative deepening stops at this depth
+    uint64_t maxNodes = UINT64_MAX; // node budget for one move
+    const atomic<bool> *stop = nullptr; // set from another thread to end the search early
+};
+
+struct QubicResult
+{
+    int cell = -1; // chosen cell
+    int score = 0; // search score for the player to move
+    int depth = 0; // deepest completed iteration
+    uint64_t nodes = 0; // nodes searched
+    double seconds = 0; // wall time spent
+};
+
+bool qubicHasLine(uint64_t stones);
+uint64_t qubicThreats(uint64_t own, uint64_t other);
+QubicResult searchQubic(const QubicBoard &board, const QubicLimits &limits);
+pair<int, int> qubicMove(const Game &game, const QubicLimits &limits);
+int qubicCellIndex(int row, int col);
+pair<int, int> qubicCellPosition(int cell);
+
+#endif
@@ -0,0 +1,125 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This header declares the reliability layer used by the UDP transport. A channel numbers every
+message, acknowledges what it receives with a cumulative sequence number plus a bitmap of the
+messages received beyond it (selective acknowledgment), retransmits on an adaptive timer and drops
+duplicates. Messages are delivered as soon as they arrive, so one lost datagram does not hold
+back the messages behind it; ordered delivery is available for comparison. The channel runs over
+any datagram link, which lets the network simulator drive it without real sockets.
+*/
+
+#ifndef RELIABLE_HPP
+#define RELIABLE_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+const uint32_t RELIABLE_WINDOW = 64; // messages in flight at once, the reach of the acknowledgment bitmap
+const size_t MAX_DATAGRAM_SIZE = 65507; // largest UDP payload
+const uint64_t INITIAL_RTO_MICROS = 100000; // retransmit timeout before the first round trip is measured
+const uint64_t MIN_RTO_MICROS = 10000;
+const uint64_t MAX_RTO_MICROS = 1000000;
+const uint64_t HEARTBEAT_MICROS = 250000; // idle time before a keep-alive is sent
+const uint64_t PEER_TIMEOUT_MICROS = 10000000; // silence, or time a message goes unacknowledged, after which the peer is considered gone
+const int MAX_BACKOFF_DOUBLINGS = 7; // times the retransmit timeout is doubled for one message
+
+/**
+ * @brief Unreliable datagram link between two endpoints.
+ */
+class DatagramLink
+{
+public:
+    virtual ~DatagramLink() {}
+
+    /**
+     * @brief Sends one datagram to the peer; it may be lost, duplicated or reordered.
+     * @return False if the link is broken.
+     */
+    virtual bool sendDatagram(const string &datagram) = 0;
+
+    /**
+     * @brief Waits up to `timeoutMicros` for a datagram from the peer.
+     * @return True if a datagram was received.
+     */
+    virtual bool receiveDatagram(string &datagram, uint64_t timeoutMicros) = 0;
+};
+
+struct ReliableStats
+{
+    uint64_t sent = 0; // messages sent
+    uint64_t delivered = 0; // messages delivered to the receiver
+    uint64_t retransmits = 0; // datagrams sent again after their timer expired
+    uint64_t duplicates = 0; // datagrams received for messages already delivered
+    uint64_t rtoMicros = 0; // current retransmit timeout
+};
+
+class ReliableChannel
+{
+public:
+    explicit ReliableChannel(DatagramLink &link, bool ordered = false);
+    ~ReliableChannel();
+
+    bool send(const string &message);
+    bool receive(string &message);
+    bool failed() const;
+    ReliableStats stats() const;
+
+private:
+    struct Outgoing
+    {
+        string datagram; // encoded message, resent as is
+        uint64_t firstSent; // microseconds
+        uint64_t lastSent;
+        int transmissions;
+    };
+
+    DatagramLink &link;
+    bool ordered; // hold messages back until every earlier one has arrived
+    thread worker; // receives datagrams and runs the retransmit timers
+
+    mutable mutex lock;
+    condition_variable windowOpen; // signalled when an acknowledgment frees room in the window
+    condition_variable messageReady; // signalled when a message is delivered or the channel fails
+    bool stopping = false;
+    bool broken = false;
+
+    // Sending side
+    uint32_t nextSequence = 1;
+    map<uint32_t, Outgoing> inFlight; // unacknowledged messages by sequence number
+    uint64_t smoothedRtt = 0; // microseconds, 0 until the first sample
+    uint64_t rttVariance = 0;
+    uint64_t rto = INITIAL_RTO_MICROS;
+    uint64_t lastSentAt = 0; // last datagram of any kind, for heartbeats
+
+    // Receiving side
+    uint32_t cumulative = 0; // every message up to this one has arrived
+    set<uint32_t> receivedAhead; // messages received past `cumulative`
+    map<uint32_t, string> heldBack; // out-of-order messages waiting for earlier ones (ordered mode)
+    deque<string> deliveredMessages; // ready for receive()
+    uint64_t lastHeardAt = 0;
+
+    ReliableStats counters;
+
+    void run();
+    void handleDatagram(const string &datagram);
+    void handleData(uint32_t sequence, const string &payload);
+    void handleAck(uint32_t cumulativeAck, uint64_t bitmap);
+    void serviceTimers();
+    void sendAck();
+    void transmit(const string &datagram);
+    void fail();
+    uint64_t retransmitDue(const Outgoing &outgoing) const;
+};
+
+#endif
@@ -0,0 +1,45 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This header declares the proof-number solver. It proves whether the player to move has a forced
+win using depth-first proof-number search (df-pn) with a bounded-memory transposition table, and
+is used by the EXPERT difficulty to play forced wins on boards too large for minimax.
+*/
+
+#ifndef SOLVER_HPP
+#define SOLVER_HPP
+
+#include "game.hpp"
+#include <cstdint>
+
+enum SOLVEVALUE {
+    PROVEN_WIN, // the player to move has a forced win
+    DISPROVEN, // no forced win exists within the searched moves
+    UNKNOWN // the node budget ran out first
+};
+
+struct SolverLimits
+{
+    uint64_t maxNodes = 2000000; // node budget for one solve
+    size_t tableMegabytes = 64; // transposition table size
+    bool threatsOnly = false; // attacker only plays moves that threaten an immediate win
+    double maxSeconds = 1.0; // wall time budget for one solve
+};
+
+struct SolveResult
+{
+    SOLVEVALUE value = UNKNOWN; // outcome of the search
+    pair<int, int> move = {-1, -1}; // first move of the forced win if proven
+    uint64_t nodes = 0; // nodes expanded
+    double seconds = 0; // wall time spent
+    double nodesPerSecond = 0; // search speed
+    size_t memoryBytes = 0; // transposition table memory
+};
+
+SolverLimits defaultSolverLimits(const Game &game);
+SolveResult solvePosition(const Game &game, const SolverLimits &limits);
+pair<int, int> expertMove(Game game, PLAYER computer);
+
+#endif
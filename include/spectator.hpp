@@ -0,0 +1,23 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This header declares spectator mode. The process that owns a game (the single-player game or the
+multiplayer server) runs a spectator hub that any number of observers can connect to; every state
+change is encoded once and the same buffer is written to all of them. Observers use watchGame()
+to follow along read-only.
+*/
+
+#ifndef SPECTATOR_HPP
+#define SPECTATOR_HPP
+
+#include "globals.hpp"
+#include "game.hpp"
+
+bool startSpectatorHub();
+void broadcastGame(const Game &game);
+size_t spectatorCount();
+void watchGame();
+
+#endif
@@ -0,0 +1,57 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This header declares the engine strength ladder. Each level fixes a search depth, a node budget,
+a softmax temperature and a noise level, so the cost of a move is bounded by the level's budget
+and strength rises steadily from random play at level 0 to full-width search at the top. The
+MEDIUM difficulty plays at one of these levels; the tournament runner can enter any of them.
+The same search also analyzes positions at full strength for the headless engine.
+*/
+
+#ifndef STRENGTH_HPP
+#define STRENGTH_HPP
+
+#include "evaluator.hpp"
+#include "game.hpp"
+#include <atomic>
+#include <cstdint>
+#include <random>
+
+struct StrengthLevel
+{
+    const char *name; // label shown in tools
+    int depth; // plies searched (0 plays a random legal move)
+    uint64_t nodeBudget; // nodes (or playouts in Ultimate) per move
+    double temperature; // softmax temperature over root move values; 0 always plays the best move
+    double noise; // standard deviation of the noise added to each root move value
+};
+
+const int STRENGTH_LEVELS = 10;
+const int MEDIUM_STRENGTH_LEVEL = 5; // level played by the MEDIUM difficulty
+
+struct AnalysisLimits
+{
+    int maxDepth = 64; // deepest iteration (plies on line boards and Qubic; unused by Ultimate)
+    uint64_t maxNodes = UINT64_MAX; // node budget (playouts in Ultimate)
+    double maxSeconds = 0; // wall time budget, 0 for none (Ultimate then uses one second)
+    const atomic<bool> *stop = nullptr; // set from another thread to end the search early
+};
+
+struct AnalysisResult
+{
+    pair<int, int> move = {-1, -1}; // best move, {-1, -1} if the game is over
+    int score = 0; // search score for the player to move (evaluator units; win rate x 1000 in Ultimate)
+    int winIn = 0; // plies to a forced win (positive) or loss (negative), 0 if none was found
+    int depth = 0; // deepest completed iteration
+    uint64_t nodes = 0; // nodes (or playouts) searched
+    double seconds = 0; // wall time spent
+};
+
+const StrengthLevel &strengthLevel(int level);
+pair<int, int> randomMoveFromMask(const Game &game, mt19937 &generator);
+pair<int, int> strengthMove(const Game &game, int level, const EvalWeights &weights = evalWeights);
+AnalysisResult analyzePosition(const Game &game, const AnalysisLimits &limits, const EvalWeights &weights = evalWeights);
+
+#endif
@@ -0,0 +1,70 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This header declares event tracing. TRACE_SPAN("name") records the time from that line to the end
+of the enclosing scope. Spans are compiled out entirely when TICTACTOE_TRACING is 0; when compiled
+in but not enabled at runtime a span costs one relaxed load and a branch. Recorded spans go into a
+ring buffer owned by the recording thread and are written out in the Chrome trace event format,
+which chrome://tracing and Perfetto can open.
+*/
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include "types.hpp"
+#include <atomic>
+#include <cstdint>
+
+#ifndef TICTACTOE_TRACING
+#define TICTACTOE_TRACING 1
+#endif
+
+using namespace std;
+
+extern atomic<bool> tracingEnabled; // spans are only recorded while this is set
+
+uint64_t traceClockNanos();
+void recordSpan(const char *name, uint64_t startNanos, uint64_t endNanos);
+void setTraceThreadName(const char *name);
+bool writeTrace(const string &path);
+void startTracing(const string &prefix);
+
+/**
+ * @brief Records a span from construction to destruction if tracing is enabled.
+ *
+ * The name must be a string literal (or otherwise outlive the trace).
+ */
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char *spanName)
+        : name(tracingEnabled.load(memory_order_relaxed) ? spanName : nullptr), start(name ? traceClockNanos() : 0)
+    {
+    }
+
+    ~TraceSpan()
+    {
+        if (name)
+            recordSpan(name, start, traceClockNanos());
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *name; // null when tracing was off at construction
+    uint64_t start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if TICTACTOE_TRACING
+#define TRACE_SPAN(name) TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name)
+#else
+#define TRACE_SPAN(name) ((void)0)
+#endif
+
+#endif
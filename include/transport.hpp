@@ -0,0 +1,107 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This header declares the message transports used in multiplayer mode. Every transport carries
+whole messages (a serialized game, an acknowledgment, ...) between the two players. TCP works
+between any two hosts; when both players run on the same machine the shared-memory transport
+passes messages through a ring buffer instead of going through the loopback network stack. The
+optional UDP transport adds its own reliability layer and delivers each message as soon as it
+arrives, so a lost packet delays only that message rather than every message behind it.
+*/
+
+#ifndef TRANSPORT_HPP
+#define TRANSPORT_HPP
+
+#include "globals.hpp"
+#include "reliable.hpp"
+#include <cstdint>
+#include <memory>
+
+using namespace std;
+
+class Transport
+{
+public:
+    virtual ~Transport() {}
+
+    /**
+     * @brief Sends one message to the peer.
+     * @return True if the message was handed off successfully.
+     */
+    virtual bool sendMessage(const string &message) = 0;
+
+    /**
+     * @brief Waits for the next message from the peer.
+     * @return True if a message was received.
+     */
+    virtual bool receiveMessage(string &message) = 0;
+
+    virtual const char *name() const = 0;
+};
+
+class TcpTransport : public Transport
+{
+public:
+    TcpTransport(TcpSocket &socket) : socket(socket) {}
+
+    bool sendMessage(const string &message) override;
+    bool receiveMessage(string &message) override;
+    const char *name() const override { return "tcp"; }
+
+private:
+    TcpSocket &socket; // connected socket to the peer
+    string buffered; // bytes received past the end of the last returned message
+};
+
+struct SharedSegment;
+
+class SharedMemoryTransport : public Transport
+{
+public:
+    static unique_ptr<SharedMemoryTransport> create();
+    static unique_ptr<SharedMemoryTransport> attach(const string &name);
+    static bool isSupported();
+    ~SharedMemoryTransport();
+
+    bool sendMessage(const string &message) override;
+    bool receiveMessage(string &message) override;
+    const char *name() const override { return "shared memory"; }
+    const string &getSegmentName() const { return segmentName; }
+    void unlink();
+
+private:
+    SharedMemoryTransport(SharedSegment *segment, const string &name, int side);
+    bool peerGone();
+
+    SharedSegment *segment; // mapped segment shared with the peer
+    string segmentName; // shm name, unlinked once the peer has attached
+    int side; // 0 for the creator (server), 1 for the peer that attached (client)
+};
+
+class UdpLink;
+
+class UdpTransport : public Transport
+{
+public:
+    static unique_ptr<UdpTransport> bind();
+    ~UdpTransport();
+
+    void connect(const IpAddress &address, unsigned short port);
+    unsigned short getLocalPort() const;
+
+    bool sendMessage(const string &message) override;
+    bool receiveMessage(string &message) override;
+    const char *name() const override { return "udp"; }
+
+private:
+    explicit UdpTransport(unique_ptr<UdpLink> link);
+
+    unique_ptr<UdpLink> link; // bound socket and the peer's address
+    unique_ptr<ReliableChannel> channel; // started once the peer's address is known
+};
+
+extern unique_ptr<Transport> transport; // transport used for the current multiplayer game
+
+#endif
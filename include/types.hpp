@@ -0,0 +1,65 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This header defines the enums and constants shared by the game rules and engines. It does not
+depend on SFML, so the core library and the command line tools build without it.
+*/
+
+#ifndef TYPES_HPP
+#define TYPES_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Board Variant Constants
+const int gomokuSize = 15;
+const int gomokuWinLength = 5;
+
+// Evaluation Cache Constants
+const bool PERSIST_CACHE = true; // snapshot the minimax cache to disk and warm-start from it
+const std::string CACHE_FILE = "evaluation.cache";
+
+// Pattern Evaluator Constants
+const std::string EVAL_WEIGHTS_FILE = "assets/evaluation.weights"; // built-in weights are used if it is missing
+
+enum PLAYER {
+    X,
+    O,
+    NONE
+};
+
+enum GAMESTATUS {
+    X_WIN,
+    O_WIN,
+    DRAW,
+    PLAYING
+};
+
+enum GAMEMODE {
+    MULTIPLAYER,
+    SINGLE_PLAYER,
+    NO_MODE,
+    SPECTATOR
+};
+
+enum DIFFICULTY {
+    EASY,
+    MEDIUM,
+    HARD,
+    EXPERT,
+    DEFAULT
+};
+
+enum VARIANT {
+    CLASSIC, // 3x3, three in a row
+    GOMOKU, // 15x15, five in a row
+    ULTIMATE, // 3x3 grid of 3x3 sub-boards
+    QUBIC // 4x4x4 cube, four in a row
+};
+
+#endif
@@ -0,0 +1,61 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This header defines the bitboard representation of Ultimate Tic Tac Toe (nine 3x3 sub-boards where
+each move decides which sub-board the opponent plays in next) and declares the Monte Carlo tree
+search engine used by the computer player in that variant.
+*/
+
+#ifndef ULTIMATE_HPP
+#define ULTIMATE_HPP
+
+#include "game.hpp"
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Ultimate Tic Tac Toe position packed into bitmasks.
+ *
+ * A move is numbered board * 9 + cell, where board and cell are both row-major 0-8. Each
+ * sub-board is a 9-bit mask per player, and sub-boards that are won or full are closed to play.
+ */
+struct UltimateBoard
+{
+    uint16_t cells[2][9]; // marks of X (0) and O (1) in each sub-board
+    uint16_t won[2]; // sub-boards won by X (0) and O (1)
+    uint16_t closed; // sub-boards that are won or full
+    int forcedBoard; // sub-board the player to move must play in, -1 if any open sub-board
+    int toMove; // 0 for X, 1 for O
+    GAMESTATUS status; // outcome of the whole game
+
+    static UltimateBoard fromGame(const Game &game);
+    int legalMoves(int *moves) const;
+    bool isLegal(int move) const;
+    void play(int move);
+};
+
+struct MctsLimits
+{
+    uint64_t maxPlayouts = 200000; // playout budget for one move
+    double maxSeconds = 1.0; // wall time budget for one move
+    double exploration = 1.0; // UCT exploration constant
+    size_t maxNodes = 1000000; // tree size cap, the tree stops growing beyond it
+    const atomic<bool> *stop = nullptr; // set from another thread to end the search early
+};
+
+struct MctsResult
+{
+    int move = -1; // chosen move (board * 9 + cell)
+    uint64_t playouts = 0; // playouts run
+    double seconds = 0; // wall time spent
+    double winRate = 0; // estimated win rate of the chosen move for the player to move
+};
+
+MctsResult searchUltimate(const UltimateBoard &board, const MctsLimits &limits);
+pair<int, int> ultimateMove(const Game &game, const MctsLimits &limits);
+int ultimateMoveIndex(int row, int col);
+pair<int, int> ultimateMoveCell(int move);
+
+#endif
@@ -0,0 +1,74 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This file implements the computer player's move selection for every variant and difficulty.
+*/
+
+#include "ai.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+#include "solver.hpp"
+#include "ultimate.hpp"
+#include "qubic.hpp"
+#include "strength.hpp"
+#include <random>
+
+bool logEngineStats = true;
+
+/**
+ * @brief Picks a random legal move (easy mode).
+ *
+ * @param game The current game state. It must still be in play.
+ * @return The row and column of a random legal cell, drawn in constant time from the legal-move mask.
+ */
+pair<int, int> randomMove(const Game &game)
+{
+    thread_local mt19937 generator(random_device{}());
+    return randomMoveFromMask(game, generator);
+}
+
+/**
+ * @brief Chooses the computer's move for the game's variant and difficulty.
+ *
+ * @param game The current game state. It must still be in play.
+ * @param computer The computer's player type (X or O).
+ * @return The row and column of the chosen move.
+ */
+pair<int, int> computerMove(const Game &game, PLAYER computer)
+{
+    TRACE_SPAN("computerMove");
+    ScopedLatency thinkTime(AI_THINK_TIME);
+    countMetric(AI_MOVES);
+
+    if (game.difficulty == EASY) // easy mode selects random empty cell
+    {
+        return randomMove(game);
+    }
+    else if (game.difficulty == MEDIUM) // medium plays a mid level of the strength ladder on every board
+    {
+        return strengthMove(game, MEDIUM_STRENGTH_LEVEL);
+    }
+    else if (game.variant == ULTIMATE) // ultimate uses the bitboard tree search, given more time on expert
+    {
+        MctsLimits limits;
+        limits.maxSeconds = (game.difficulty == EXPERT) ? 2.0 : 0.5;
+        return ultimateMove(game, limits);
+    }
+    else if (game.variant == QUBIC) // qubic uses the bitboard alpha-beta search, given more time on expert
+    {
+        QubicLimits limits;
+        limits.maxSeconds = (game.difficulty == EXPERT) ? 2.0 : 0.5;
+        return qubicMove(game, limits);
+    }
+    else if (game.difficulty == HARD && game.variant == CLASSIC) // hard mode uses minimax algorithm to find optimal move
+    {
+        TRACE_SPAN("minimax");
+        pair<int, int> move;
+        minimax(game, move, computer);
+        return move;
+    }
+    // expert mode (and hard mode on boards too large for minimax) plays proven wins from the solver
+    return expertMove(game, computer);
+}
@@ -0,0 +1,398 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This file implements the AI service. Each request for a deterministic difficulty (hard or expert)
+is reduced to a canonical position, the smallest of the board's eight rotations and reflections
+(on the Qubic board the same transform is applied to every layer, which turns the whole cube), and
+the canonical position names the cache entry and the in-flight search that requests share. The
+move found on the canonical board is mapped back through each requester's own symmetry. Easy
+requests are answered on the caller's thread, since a random move costs less than a hand-off,
+and medium requests are searched but never shared, since their noise is meant to vary.
+*/
+
+#include "aiservice.hpp"
+#include "ai.hpp"
+#include "metrics.hpp"
+#include "strength.hpp"
+#include <algorithm>
+
+namespace
+{
+const int SYMMETRIES = 8;
+
+struct SymmetryTable
+{
+    vector<int> forward[SYMMETRIES]; // cell on the requester's board -> cell on the transformed board
+    vector<int> inverse[SYMMETRIES];
+};
+
+/**
+ * @brief Builds the cell permutations of a square board's rotations and reflections.
+ *
+ * @param size Side of the board.
+ * @param block Side of the blocks the transform is applied within (the Qubic layers), or `size`.
+ */
+SymmetryTable buildSymmetries(int size, int block)
+{
+    SymmetryTable table;
+    for (int t = 0; t < SYMMETRIES; ++t)
+    {
+        table.forward[t].resize(size * size);
+        table.inverse[t].resize(size * size);
+        for (int row = 0; row < size; ++row)
+        {
+            for (int col = 0; col < size; ++col)
+            {
+                int r = row % block, c = col % block;
+                if (t & 4)
+                    swap(r, c);
+                if (t & 1)
+                    r = block - 1 - r;
+                if (t & 2)
+                    c = block - 1 - c;
+                int from = row * size + col;
+                int to = (row - row % block + r) * size + (col - col % block + c);
+                table.forward[t][from] = to;
+                table.inverse[t][to] = from;
+            }
+        }
+    }
+    return table;
+}
+
+const SymmetryTable &symmetries(VARIANT variant)
+{
+    static const SymmetryTable classic = buildSymmetries(3, 3);
+    static const SymmetryTable gomoku = buildSymmetries(gomokuSize, gomokuSize);
+    static const SymmetryTable ultimate = buildSymmetries(9, 9);
+    static const SymmetryTable qubic = buildSymmetries(8, 4);
+    switch (variant)
+    {
+    case GOMOKU:
+        return gomoku;
+    case ULTIMATE:
+        return ultimate;
+    case QUBIC:
+        return qubic;
+    default:
+        return classic;
+    }
+}
+
+pair<int, int> mapMove(const vector<int> &permutation, pair<int, int> move, int cols)
+{
+    if (move.first < 0)
+        return move;
+    int cell = permutation[move.first * cols + move.second];
+    return {cell / cols, cell % cols};
+}
+
+/**
+ * @brief Finds the symmetry that turns the position into its canonical form.
+ *
+ * @param key Receives the name of the canonical position: the variant, difficulty, players and
+ *            the transformed cells (and, in Ultimate, the transformed last move).
+ * @param canonical Receives the canonical position. It must start as a copy of `game`.
+ * @return The symmetry used.
+ */
+int canonicalize(const Game &game, PLAYER computer, string &key, Game &canonical)
+{
+    const SymmetryTable &table = symmetries(game.variant);
+    int cells = game.rows * game.cols;
+    string best;
+    int bestSymmetry = 0;
+    for (int t = 0; t < SYMMETRIES; ++t)
+    {
+        string text(cells, '0');
+        for (int cell = 0; cell < cells; ++cell)
+            text[table.forward[t][cell]] = static_cast<char>('0' + game.grid[cell / game.cols][cell % game.cols]);
+        if (game.variant == ULTIMATE)
+        {
+            pair<int, int> last = mapMove(table.forward[t], game.lastMove, game.cols);
+            text += " " + to_string(last.first) + "," + to_string(last.second);
+        }
+        if (t == 0 || text < best)
+        {
+            best = text;
+            bestSymmetry = t;
+        }
+    }
+    key = to_string(game.variant) + " " + to_string(game.difficulty) + " " + to_string(computer) + " " +
+          to_string(game.activeTurn) + " " + best;
+
+    // The caller's copy keeps the mode and difficulty; setPosition replaces the rest
+    vector<int> marks(cells);
+    for (int cell = 0; cell < cells; ++cell)
+        marks[cell] = best[cell] - '0';
+    pair<int, int> last = mapMove(table.forward[bestSymmetry], game.lastMove, game.cols);
+    canonical.setPosition(game.variant, marks, game.activeTurn, last);
+    return bestSymmetry;
+}
+}
+
+/**
+ * @brief Starts the worker pool.
+ *
+ * @param threads Worker threads searching positions.
+ * @param cacheEntries Positions kept in the result cache; the oldest is dropped when it is full.
+ * @param queueCapacity Positions that may wait for a worker; requests beyond it get a fallback move.
+ */
+AiService::AiService(int threads, size_t cacheEntries, size_t queueCapacity)
+    : cacheEntries(cacheEntries), queueCapacity(queueCapacity)
+{
+    for (int i = 0; i < threads; ++i)
+        workers.emplace_back(&AiService::runWorker, this);
+    deadlineWatcher = thread(&AiService::watchDeadlines, this);
+}
+
+/**
+ * @brief Stops the service. Searches in progress finish; queued requests get a fallback move.
+ */
+AiService::~AiService()
+{
+    vector<unique_ptr<Waiter>> abandoned;
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+        for (const shared_ptr<Job> &job : queue)
+        {
+            for (auto &waiter : job->waiters)
+                abandoned.push_back(move(waiter));
+            job->waiters.clear();
+        }
+        queue.clear();
+    }
+    jobReady.notify_all();
+    deadlineChanged.notify_all();
+    for (auto &waiter : abandoned)
+        answerWithFallback(*waiter);
+    for (thread &worker : workers)
+        worker.join();
+    deadlineWatcher.join();
+}
+
+/**
+ * @brief Asks for the computer's move in a game.
+ *
+ * @param game The current game state. It must still be in play.
+ * @param computer The computer's player type (X or O).
+ * @param deadlineSeconds Time after which the request is answered with a fallback move if the
+ *        search has not finished.
+ * @return The reply, ready once the move is known.
+ */
+future<AiReply> AiService::requestMove(const Game &game, PLAYER computer, double deadlineSeconds)
+{
+    countMetric(AI_SERVICE_REQUESTS);
+    unique_ptr<Waiter> waiter(new Waiter{promise<AiReply>(), game, computer, 0, metricsClockMicros(), 0, false});
+    waiter->deadline = waiter->requestedAt + static_cast<uint64_t>(max(0.0, deadlineSeconds) * 1e6);
+    future<AiReply> reply = waiter->reply.get_future();
+
+    if (game.difficulty == EASY)
+    {
+        {
+            lock_guard<mutex> guard(lock);
+            counters.requests++;
+        }
+        answer(*waiter, computerMove(game, computer), false);
+        return reply;
+    }
+
+    // Only deterministic engines may share a search or a cached answer
+    bool shareable = game.difficulty == HARD || game.difficulty == EXPERT;
+    string key;
+    Game canonical = game;
+    if (shareable)
+        waiter->symmetry = canonicalize(game, computer, key, canonical);
+
+    unique_lock<mutex> guard(lock);
+    counters.requests++;
+    if (shareable)
+    {
+        auto cached = cache.find(key);
+        if (cached != cache.end())
+        {
+            counters.cacheHits++;
+            countMetric(AI_SERVICE_CACHE_HITS);
+            answer(*waiter, cached->second, true);
+            return reply;
+        }
+        auto running = inFlight.find(key);
+        if (running != inFlight.end())
+        {
+            Job &job = *running->second;
+            counters.coalesced++;
+            countMetric(AI_SERVICE_COALESCED);
+            waiter->coalesced = true;
+            job.deadline = min(job.deadline, waiter->deadline);
+            job.waiters.push_back(move(waiter));
+            waiting++;
+            updateGauges();
+            deadlineChanged.notify_one();
+            return reply;
+        }
+    }
+    if (queue.size() >= queueCapacity)
+    {
+        guard.unlock();
+        answerWithFallback(*waiter);
+        return reply;
+    }
+
+    shared_ptr<Job> job(new Job{key, canonical, computer, metricsClockMicros(), waiter->deadline, {}});
+    job->waiters.push_back(move(waiter));
+    queue.push_back(job);
+    if (shareable)
+        inFlight[key] = job;
+    waiting++;
+    counters.peakQueueDepth = max(counters.peakQueueDepth, queue.size());
+    updateGauges();
+    jobReady.notify_one();
+    deadlineChanged.notify_one();
+    return reply;
+}
+
+AiServiceStats AiService::stats() const
+{
+    lock_guard<mutex> guard(lock);
+    return counters;
+}
+
+/**
+ * @brief Worker loop: searches the queued position with the earliest deadline and answers every
+ *        request waiting for it.
+ */
+void AiService::runWorker()
+{
+    unique_lock<mutex> guard(lock);
+    while (true)
+    {
+        jobReady.wait(guard, [this] { return stopping || !queue.empty(); });
+        if (stopping)
+            return;
+        auto next = min_element(queue.begin(), queue.end(), [](const shared_ptr<Job> &a, const shared_ptr<Job> &b) {
+            return a->deadline < b->deadline;
+        });
+        shared_ptr<Job> job = *next;
+        queue.erase(next);
+        counters.searches++;
+        recordLatency(AI_SERVICE_QUEUE_WAIT, metricsClockMicros() - job->queuedAt);
+        updateGauges();
+
+        guard.unlock();
+        pair<int, int> move = computerMove(job->game, job->computer);
+        guard.lock();
+
+        if (!job->key.empty())
+        {
+            inFlight.erase(job->key);
+            if (cache.size() >= cacheEntries && !cacheOrder.empty())
+            {
+                cache.erase(cacheOrder.front());
+                cacheOrder.pop_front();
+            }
+            if (cache.emplace(job->key, move).second)
+                cacheOrder.push_back(job->key);
+        }
+        for (auto &waiter : job->waiters)
+            answer(*waiter, move, false);
+        waiting -= job->waiters.size();
+        job->waiters.clear();
+        updateGauges();
+    }
+}
+
+/**
+ * @brief Answers requests whose deadline has passed with a fallback move, dropping queued
+ *        positions nobody is waiting for any more.
+ */
+void AiService::watchDeadlines()
+{
+    unique_lock<mutex> guard(lock);
+    while (!stopping)
+    {
+        uint64_t now = metricsClockMicros();
+        uint64_t nextDeadline = now + 1000000;
+        vector<unique_ptr<Waiter>> expired;
+        auto visit = [&](Job &job) {
+            auto late = stable_partition(job.waiters.begin(), job.waiters.end(),
+                                         [now](const unique_ptr<Waiter> &waiter) { return waiter->deadline > now; });
+            for (auto it = late; it != job.waiters.end(); ++it)
+                expired.push_back(move(*it));
+            job.waiters.erase(late, job.waiters.end());
+            job.deadline = UINT64_MAX;
+            for (const auto &waiter : job.waiters)
+                job.deadline = min(job.deadline, waiter->deadline);
+            nextDeadline = min(nextDeadline, job.deadline);
+        };
+        for (auto &entry : inFlight)
+            visit(*entry.second);
+        for (const shared_ptr<Job> &job : queue)
+        {
+            if (job->key.empty())
+                visit(*job);
+        }
+        // Unshared searches already running are left to finish; their requests get the result
+        queue.erase(remove_if(queue.begin(), queue.end(),
+                              [this](const shared_ptr<Job> &job) {
+                                  if (!job->waiters.empty())
+                                      return false;
+                                  if (!job->key.empty())
+                                      inFlight.erase(job->key);
+                                  return true;
+                              }),
+                    queue.end());
+
+        if (!expired.empty())
+        {
+            waiting -= expired.size();
+            updateGauges();
+            guard.unlock();
+            for (auto &waiter : expired)
+                answerWithFallback(*waiter);
+            guard.lock();
+            continue; // time has passed; look again
+        }
+        deadlineChanged.wait_for(guard, chrono::microseconds(nextDeadline - now));
+    }
+}
+
+/**
+ * @brief Fulfils a request with a move found on the canonical board, mapped back to its own board.
+ */
+void AiService::answer(Waiter &waiter, pair<int, int> canonicalMove, bool cached)
+{
+    AiReply reply;
+    reply.move = mapMove(symmetries(waiter.game.variant).inverse[waiter.symmetry], canonicalMove, waiter.game.cols);
+    reply.cached = cached;
+    reply.coalesced = waiter.coalesced;
+    recordLatency(AI_SERVICE_LATENCY, metricsClockMicros() - waiter.requestedAt);
+    waiter.reply.set_value(reply);
+}
+
+/**
+ * @brief Fulfils a request with a quick move from a low ladder level. Called without the lock held.
+ */
+void AiService::answerWithFallback(Waiter &waiter)
+{
+    AiReply reply;
+    reply.move = strengthMove(waiter.game, FALLBACK_STRENGTH_LEVEL);
+    reply.fallback = true;
+    countMetric(AI_SERVICE_FALLBACKS);
+    {
+        lock_guard<mutex> guard(lock);
+        counters.fallbacks++;
+    }
+    recordLatency(AI_SERVICE_LATENCY, metricsClockMicros() - waiter.requestedAt);
+    waiter.reply.set_value(reply);
+}
+
+/**
+ * @brief Publishes the queue depth and the number of unanswered requests. Called with the lock held.
+ */
+void AiService::updateGauges()
+{
+    setGauge(AI_SERVICE_QUEUE_DEPTH, static_cast<int64_t>(queue.size()));
+    setGauge(AI_SERVICE_WAITING, static_cast<int64_t>(waiting));
+}
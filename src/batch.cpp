@@ -0,0 +1,239 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This file implements batch win detection for packed 3x3 boards. Each board is classified as
+X_WIN, O_WIN, DRAW or PLAYING. When both players have a line (which cannot happen in a real game),
+the first line in `Game::updateGameStatus` order decides, so every path gives the same answer as
+the scalar game logic for every possible board. The AVX2 path handles 16 boards per step, the
+SSE2 path 8, and leftover boards go through the scalar path.
+*/
+
+#include "batch.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define BATCH_X86 1
+#endif
+
+namespace
+{
+// Winning lines in the order `Game::updateGameStatus` checks them: row i and column i for each i, then the diagonals
+const uint16_t LINES[8] = {0x007, 0x049, 0x038, 0x092, 0x1C0, 0x124, 0x111, 0x054};
+const uint16_t FULL_BOARD = 0x1FF;
+
+typedef void (*Classifier)(const uint16_t *, const uint16_t *, uint8_t *, size_t);
+
+#ifdef BATCH_X86
+/**
+ * @brief Classifies boards 8 at a time with SSE2 (one board per 16-bit lane).
+ */
+__attribute__((target("sse2"))) void classifySse2(const uint16_t *xMasks, const uint16_t *oMasks, uint8_t *results, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(xMasks + i));
+        __m128i o = _mm_loadu_si128(reinterpret_cast<const __m128i *>(oMasks + i));
+
+        // Set bit k of xLines/oLines when the player holds line k
+        __m128i xLines = _mm_setzero_si128(), oLines = _mm_setzero_si128();
+        for (int line = 0; line < 8; ++line)
+        {
+            __m128i mask = _mm_set1_epi16(static_cast<short>(LINES[line]));
+            __m128i bit = _mm_set1_epi16(static_cast<short>(1 << line));
+            xLines = _mm_or_si128(xLines, _mm_and_si128(_mm_cmpeq_epi16(_mm_and_si128(x, mask), mask), bit));
+            oLines = _mm_or_si128(oLines, _mm_and_si128(_mm_cmpeq_epi16(_mm_and_si128(o, mask), mask), bit));
+        }
+
+        // The lowest line held by anyone decides the winner
+        __m128i anyLines = _mm_or_si128(xLines, oLines);
+        __m128i firstLine = _mm_and_si128(anyLines, _mm_sub_epi16(_mm_setzero_si128(), anyLines));
+        __m128i won = _mm_cmpeq_epi16(_mm_cmpeq_epi16(anyLines, _mm_setzero_si128()), _mm_setzero_si128());
+        __m128i oFirst = _mm_cmpeq_epi16(_mm_and_si128(firstLine, xLines), _mm_setzero_si128());
+        __m128i full = _mm_cmpeq_epi16(_mm_or_si128(x, o), _mm_set1_epi16(FULL_BOARD));
+
+        // PLAYING, or DRAW when full; then X_WIN (0) / O_WIN (1) when someone won
+        __m128i status = _mm_sub_epi16(_mm_set1_epi16(PLAYING), _mm_and_si128(full, _mm_set1_epi16(PLAYING - DRAW)));
+        __m128i winner = _mm_and_si128(oFirst, _mm_set1_epi16(O_WIN));
+        status = _mm_or_si128(_mm_and_si128(won, winner), _mm_andnot_si128(won, status));
+
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(results + i), _mm_packus_epi16(status, status));
+    }
+    classifyBoardsScalar(xMasks + i, oMasks + i, results + i, count - i);
+}
+
+/**
+ * @brief Classifies boards 16 at a time with AVX2 (one board per 16-bit lane).
+ */
+__attribute__((target("avx2"))) void classifyAvx2(const uint16_t *xMasks, const uint16_t *oMasks, uint8_t *results, size_t count)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(xMasks + i));
+        __m256i o = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(oMasks + i));
+
+        __m256i xLines = _mm256_setzero_si256(), oLines = _mm256_setzero_si256();
+        for (int line = 0; line < 8; ++line)
+        {
+            __m256i mask = _mm256_set1_epi16(static_cast<short>(LINES[line]));
+            __m256i bit = _mm256_set1_epi16(static_cast<short>(1 << line));
+            xLines = _mm256_or_si256(xLines, _mm256_and_si256(_mm256_cmpeq_epi16(_mm256_and_si256(x, mask), mask), bit));
+            oLines = _mm256_or_si256(oLines, _mm256_and_si256(_mm256_cmpeq_epi16(_mm256_and_si256(o, mask), mask), bit));
+        }
+
+        __m256i anyLines = _mm256_or_si256(xLines, oLines);
+        __m256i firstLine = _mm256_and_si256(anyLines, _mm256_sub_epi16(_mm256_setzero_si256(), anyLines));
+        __m256i won = _mm256_cmpeq_epi16(_mm256_cmpeq_epi16(anyLines, _mm256_setzero_si256()), _mm256_setzero_si256());
+        __m256i oFirst = _mm256_cmpeq_epi16(_mm256_and_si256(firstLine, xLines), _mm256_setzero_si256());
+        __m256i full = _mm256_cmpeq_epi16(_mm256_or_si256(x, o), _mm256_set1_epi16(FULL_BOARD));
+
+        __m256i status = _mm256_sub_epi16(_mm256_set1_epi16(PLAYING), _mm256_and_si256(full, _mm256_set1_epi16(PLAYING - DRAW)));
+        __m256i winner = _mm256_and_si256(oFirst, _mm256_set1_epi16(O_WIN));
+        status = _mm256_blendv_epi8(status, winner, won);
+
+        // Pack 16 lanes to bytes; packus works per 128-bit half, so gather the halves back in order
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(status, status), 0x08);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(results + i), _mm256_castsi256_si128(packed));
+    }
+    classifySse2(xMasks + i, oMasks + i, results + i, count - i);
+}
+#endif
+
+struct Dispatch
+{
+    Classifier classify; // fastest classifier this CPU supports
+    const char *name; // its name
+};
+
+/**
+ * @brief Looks up a classifier by name.
+ *
+ * @return The classifier, or null if it is unknown, not built for this target, or not supported
+ *         by this CPU.
+ */
+Classifier findClassifier(const string &name)
+{
+#ifdef BATCH_X86
+    __builtin_cpu_init();
+    if (name == "avx2")
+        return __builtin_cpu_supports("avx2") ? classifyAvx2 : nullptr;
+    if (name == "sse2")
+        return __builtin_cpu_supports("sse2") ? classifySse2 : nullptr;
+#endif
+    if (name == "scalar")
+        return classifyBoardsScalar;
+    return nullptr;
+}
+
+/**
+ * @brief Picks the fastest classifier the CPU supports, once, on first use.
+ */
+const Dispatch &dispatch()
+{
+    static const Dispatch selected = []() -> Dispatch {
+        for (const char *name : BATCH_CLASSIFIERS)
+        {
+            if (Classifier classify = findClassifier(name))
+                return {classify, name};
+        }
+        return {classifyBoardsScalar, "scalar"};
+    }();
+    return selected;
+}
+}
+
+/**
+ * @brief Packs a classic 3x3 game into X and O masks (bit = row * 3 + col).
+ *
+ * @param game The game to pack. It must use the CLASSIC variant.
+ * @param xMask Receives the cells marked X.
+ * @param oMask Receives the cells marked O.
+ */
+void packBoard(const Game &game, uint16_t &xMask, uint16_t &oMask)
+{
+    xMask = 0;
+    oMask = 0;
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int col = 0; col < 3; ++col)
+        {
+            if (game.grid[row][col] == 1)
+                xMask |= 1 << (row * 3 + col);
+            else if (game.grid[row][col] == 2)
+                oMask |= 1 << (row * 3 + col);
+        }
+    }
+}
+
+/**
+ * @brief Classifies packed 3x3 boards with the fastest path the CPU supports.
+ *
+ * @param xMasks X marks of each board.
+ * @param oMasks O marks of each board (must not overlap the X marks).
+ * @param results Receives a GAMESTATUS value for each board.
+ * @param count Number of boards.
+ */
+void classifyBoards(const uint16_t *xMasks, const uint16_t *oMasks, uint8_t *results, size_t count)
+{
+    dispatch().classify(xMasks, oMasks, results, count);
+}
+
+/**
+ * @brief Classifies packed 3x3 boards with a chosen path, so each path can be checked on its own.
+ *
+ * @param name One of `BATCH_CLASSIFIERS`.
+ * @param xMasks X marks of each board.
+ * @param oMasks O marks of each board (must not overlap the X marks).
+ * @param results Receives a GAMESTATUS value for each board.
+ * @param count Number of boards.
+ * @return False (leaving the results untouched) if this CPU cannot run the path.
+ */
+bool classifyBoardsWith(const string &name, const uint16_t *xMasks, const uint16_t *oMasks, uint8_t *results, size_t count)
+{
+    Classifier classify = findClassifier(name);
+    if (!classify)
+        return false;
+    classify(xMasks, oMasks, results, count);
+    return true;
+}
+
+/**
+ * @brief Classifies packed 3x3 boards one at a time. This is the reference the vector paths match.
+ *
+ * @param xMasks X marks of each board.
+ * @param oMasks O marks of each board (must not overlap the X marks).
+ * @param results Receives a GAMESTATUS value for each board.
+ * @param count Number of boards.
+ */
+void classifyBoardsScalar(const uint16_t *xMasks, const uint16_t *oMasks, uint8_t *results, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint8_t status = ((xMasks[i] | oMasks[i]) == FULL_BOARD) ? DRAW : PLAYING;
+        for (uint16_t line : LINES)
+        {
+            if ((xMasks[i] & line) == line)
+            {
+                status = X_WIN;
+                break;
+            }
+            if ((oMasks[i] & line) == line)
+            {
+                status = O_WIN;
+                break;
+            }
+        }
+        results[i] = status;
+    }
+}
+
+/**
+ * @brief Returns the name of the classifier picked for this CPU ("avx2", "sse2" or "scalar").
+ */
+const char *batchClassifierName()
+{
+    return dispatch().name;
+}
@@ -0,0 +1,276 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This file implements the evaluation cache used by the minimax search. It provides thread-safe
+lookup and store operations and a binary snapshot format with a header (magic, version and board
+variant) and a trailing checksum, so a stale or corrupted snapshot is rejected instead of loaded.
+*/
+
+#include "cache.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+EvaluationCache evaluationCache;
+
+namespace
+{
+const char CACHE_MAGIC[8] = {'T', 'T', 'T', 'C', 'A', 'C', 'H', 'E'};
+const uint32_t CACHE_VERSION = 1;
+
+// Board variant the cached keys belong to (rows, columns, marks in a row to win)
+const uint32_t CACHE_ROWS = 3;
+const uint32_t CACHE_COLS = 3;
+const uint32_t CACHE_WIN_LENGTH = 3;
+
+/**
+ * @brief Folds a block of bytes into a running 64-bit FNV-1a checksum.
+ */
+void checksum(uint64_t &hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+/**
+ * @brief Writes a value to the stream and adds it to the checksum.
+ */
+template <typename T>
+void writeValue(ostream &out, uint64_t &hash, const T &value)
+{
+    out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    checksum(hash, &value, sizeof(value));
+}
+
+/**
+ * @brief Reads a value from the stream and adds it to the checksum.
+ * @return True if the value was read completely.
+ */
+template <typename T>
+bool readValue(istream &in, uint64_t &hash, T &value)
+{
+    if (!in.read(reinterpret_cast<char *>(&value), sizeof(value)))
+        return false;
+    checksum(hash, &value, sizeof(value));
+    return true;
+}
+}
+
+/**
+ * @brief Looks up a cached result for a position.
+ *
+ * @param key The position key (see `Game::key`).
+ * @param entry Receives the cached result if one exists.
+ * @return True if the position was found in the cache.
+ */
+bool EvaluationCache::lookup(uint64_t key, CacheEntry &entry) const
+{
+    shared_lock<shared_mutex> guard(lock);
+    auto it = entries.find(key);
+    if (it == entries.end())
+        return false;
+    entry = it->second;
+    return true;
+}
+
+/**
+ * @brief Stores the result of a search for a position.
+ *
+ * @param key The position key (see `Game::key`).
+ * @param entry The result to store.
+ */
+void EvaluationCache::store(uint64_t key, const CacheEntry &entry)
+{
+    unique_lock<shared_mutex> guard(lock);
+    entries[key] = entry;
+}
+
+/**
+ * @brief Removes every entry from the cache.
+ */
+void EvaluationCache::clear()
+{
+    unique_lock<shared_mutex> guard(lock);
+    entries.clear();
+}
+
+/**
+ * @brief Returns the number of cached positions.
+ */
+size_t EvaluationCache::size() const
+{
+    shared_lock<shared_mutex> guard(lock);
+    return entries.size();
+}
+
+/**
+ * @brief Writes a snapshot of the cache to disk.
+ *
+ * The snapshot is written to a temporary file first and then renamed over the old one, so a
+ * crash during the write never leaves a truncated snapshot behind.
+ *
+ * @param path The snapshot file path.
+ * @return True if the snapshot was written successfully.
+ */
+bool EvaluationCache::save(const string &path) const
+{
+    string tempPath = path + ".tmp";
+    {
+        ofstream out(tempPath, ios::binary | ios::trunc);
+        if (!out)
+        {
+            cerr << "Failed to open evaluation cache file for writing!" << endl;
+            return false;
+        }
+
+        shared_lock<shared_mutex> guard(lock);
+        uint64_t hash = 14695981039346656037ULL;
+
+        out.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        writeValue(out, hash, CACHE_VERSION);
+        writeValue(out, hash, CACHE_ROWS);
+        writeValue(out, hash, CACHE_COLS);
+        writeValue(out, hash, CACHE_WIN_LENGTH);
+        writeValue(out, hash, static_cast<uint64_t>(entries.size()));
+
+        for (const auto &item : entries)
+        {
+            writeValue(out, hash, item.first);
+            writeValue(out, hash, static_cast<int32_t>(item.second.score));
+            writeValue(out, hash, static_cast<int8_t>(item.second.row));
+            writeValue(out, hash, static_cast<int8_t>(item.second.col));
+        }
+
+        out.write(reinterpret_cast<const char *>(&hash), sizeof(hash));
+        if (!out)
+        {
+            cerr << "Failed to write evaluation cache!" << endl;
+            return false;
+        }
+    }
+
+    if (rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        cerr << "Failed to replace evaluation cache file!" << endl;
+        remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Loads a snapshot from disk, replacing the current cache contents.
+ *
+ * The snapshot is rejected if the magic, version or board variant does not match this build,
+ * if any entry is out of range, or if the checksum does not match. A rejected snapshot leaves
+ * the cache untouched.
+ *
+ * @param path The snapshot file path.
+ * @return True if the snapshot was loaded.
+ */
+bool EvaluationCache::load(const string &path)
+{
+    ifstream in(path, ios::binary);
+    if (!in)
+        return false; // no snapshot yet, start cold
+
+    char magic[sizeof(CACHE_MAGIC)];
+    uint64_t hash = 14695981039346656037ULL;
+    uint32_t version, rows, cols, winLength;
+    uint64_t count;
+
+    if (!in.read(magic, sizeof(magic)) || memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0)
+    {
+        cerr << "Evaluation cache file is not a cache snapshot, ignoring it" << endl;
+        return false;
+    }
+    if (!readValue(in, hash, version) || version != CACHE_VERSION)
+    {
+        cerr << "Evaluation cache version mismatch, ignoring it" << endl;
+        return false;
+    }
+    if (!readValue(in, hash, rows) || !readValue(in, hash, cols) || !readValue(in, hash, winLength) ||
+        rows != CACHE_ROWS || cols != CACHE_COLS || winLength != CACHE_WIN_LENGTH)
+    {
+        cerr << "Evaluation cache was built for a different board, ignoring it" << endl;
+        return false;
+    }
+    if (!readValue(in, hash, count))
+    {
+        cerr << "Evaluation cache is truncated, ignoring it" << endl;
+        return false;
+    }
+
+    // Check the count against the bytes left before trusting it with an allocation
+    const uint64_t entrySize = sizeof(uint64_t) + sizeof(int32_t) + 2 * sizeof(int8_t);
+    streampos entriesStart = in.tellg();
+    in.seekg(0, ios::end);
+    uint64_t remaining = static_cast<uint64_t>(in.tellg() - entriesStart);
+    in.seekg(entriesStart);
+    if (remaining < sizeof(uint64_t) || count > (remaining - sizeof(uint64_t)) / entrySize)
+    {
+        cerr << "Evaluation cache is truncated, ignoring it" << endl;
+        return false;
+    }
+
+    unordered_map<uint64_t, CacheEntry> loaded;
+    loaded.reserve(count);
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        uint64_t key;
+        int32_t score;
+        int8_t row, col;
+        if (!readValue(in, hash, key) || !readValue(in, hash, score) ||
+            !readValue(in, hash, row) || !readValue(in, hash, col))
+        {
+            cerr << "Evaluation cache is truncated, ignoring it" << endl;
+            return false;
+        }
+        if (row < 0 || row >= (int)rows || col < 0 || col >= (int)cols || score < -10 || score > 10)
+        {
+            cerr << "Evaluation cache contains an invalid entry, ignoring it" << endl;
+            return false;
+        }
+        loaded[key] = {score, row, col};
+    }
+
+    uint64_t storedHash;
+    if (!in.read(reinterpret_cast<char *>(&storedHash), sizeof(storedHash)) || storedHash != hash)
+    {
+        cerr << "Evaluation cache checksum mismatch, ignoring it" << endl;
+        return false;
+    }
+
+    unique_lock<shared_mutex> guard(lock);
+    entries.swap(loaded);
+    return true;
+}
+
+/**
+ * @brief Warm-starts the global cache from the snapshot file if persistence is enabled.
+ */
+void loadEvaluationCache()
+{
+    if (PERSIST_CACHE && evaluationCache.load(CACHE_FILE))
+    {
+        cout << "Loaded " << evaluationCache.size() << " cached positions" << endl;
+    }
+}
+
+/**
+ * @brief Snapshots the global cache to the snapshot file if persistence is enabled.
+ */
+void saveEvaluationCache()
+{
+    if (PERSIST_CACHE)
+    {
+        evaluationCache.save(CACHE_FILE);
+    }
+}
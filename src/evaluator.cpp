@@ -0,0 +1,317 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This file implements the pattern evaluator. Every line keeps the marks each player has in it;
+playing or undoing a mark touches only the lines through that cell, moving each between the
+open-line buckets and updating the per-cell threat and fork counters of the cells it covers.
+A full rescore recounts everything from the cells with branchless passes over the per-line counts,
+and is used to build the state for a whole board at once. The weights file has one `key value`
+pair per line (line1 to line8, threat, fork, tempo); `#` starts a comment.
+*/
+
+#include "evaluator.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+EvalWeights evalWeights;
+
+/**
+ * @brief Reads evaluation weights from a weights file.
+ *
+ * @param path The weights file.
+ * @param weights The weights to update. Keys missing from the file keep their current values.
+ * @return True if the file was read, false if it could not be opened.
+ */
+bool loadEvalWeights(const string &path, EvalWeights &weights)
+{
+    ifstream file(path);
+    if (!file)
+    {
+        return false;
+    }
+
+    string text;
+    int lineNumber = 0;
+    while (getline(file, text))
+    {
+        lineNumber++;
+        text = text.substr(0, text.find('#'));
+        istringstream iss(text);
+        string key;
+        int value;
+        if (!(iss >> key))
+        {
+            continue; // blank or comment line
+        }
+        if (!(iss >> value))
+        {
+            cerr << path << ":" << lineNumber << ": missing value for " << key << endl;
+            continue;
+        }
+
+        if (key == "threat")
+            weights.threat = value;
+        else if (key == "fork")
+            weights.fork = value;
+        else if (key == "tempo")
+            weights.tempo = value;
+        else if (key.compare(0, 4, "line") == 0 && key.size() == 5 && key[4] >= '1' && key[4] <= '0' + MAX_PATTERN_LENGTH)
+            weights.line[key[4] - '0'] = value;
+        else
+            cerr << path << ":" << lineNumber << ": unknown weight " << key << endl;
+    }
+    return true;
+}
+
+/**
+ * @brief Constructs an evaluator for an empty board.
+ */
+PatternEvaluator::PatternEvaluator(const LineTable &lines, const EvalWeights &weights)
+{
+    reset(lines, weights);
+}
+
+/**
+ * @brief Starts tracking an empty board with the given lines and weights.
+ */
+void PatternEvaluator::reset(const LineTable &lines, const EvalWeights &weights)
+{
+    this->lines = &lines;
+    this->weights = &weights;
+    length = lines.length; // at most MAX_PATTERN_LENGTH
+    cells.assign(lines.rows * lines.cols, 0);
+    for (int player = 0; player < 2; ++player)
+    {
+        count[player].assign(lines.count, 0);
+        nearWin[player].assign(cells.size(), 0);
+        nearFork[player].assign(cells.size(), 0);
+        fill(begin(open[player]), end(open[player]), 0);
+        winningCells[player] = 0;
+        forkCells[player] = 0;
+    }
+}
+
+/**
+ * @brief Stops tracking a board, releasing the counters.
+ */
+void PatternEvaluator::clear()
+{
+    *this = PatternEvaluator();
+}
+
+/**
+ * @brief Places a mark and updates the counts of every line through it.
+ *
+ * @param cell The cell index (row * cols + col). It must be empty.
+ * @param player 0 for X, 1 for O.
+ */
+void PatternEvaluator::play(int cell, int player)
+{
+    if (!lines)
+    {
+        return;
+    }
+    setCellEmpty(cell, false);
+    cells[cell] = static_cast<int8_t>(player + 1);
+    for (int line : lines->linesByCell[cell])
+    {
+        applyLine(line, -1);
+        count[player][line]++;
+        applyLine(line, 1);
+    }
+}
+
+/**
+ * @brief Removes a mark placed by play().
+ */
+void PatternEvaluator::undo(int cell, int player)
+{
+    if (!lines)
+    {
+        return;
+    }
+    for (int line : lines->linesByCell[cell])
+    {
+        applyLine(line, -1);
+        count[player][line]--;
+        applyLine(line, 1);
+    }
+    cells[cell] = 0;
+    setCellEmpty(cell, true);
+}
+
+/**
+ * @brief Loads a whole board at once, recounting every line instead of replaying the moves.
+ *
+ * @param grid The marks on the board (0 empty, 1 X, 2 O), rows x cols as in the line table.
+ */
+void PatternEvaluator::setBoard(const vector<vector<int>> &grid)
+{
+    if (!lines)
+    {
+        return;
+    }
+    for (int cell = 0; cell < static_cast<int>(cells.size()); ++cell)
+        cells[cell] = static_cast<int8_t>(grid[cell / lines->cols][cell % lines->cols]);
+    rescore();
+}
+
+/**
+ * @brief Recounts every line and cell counter from the marks on the board.
+ */
+void PatternEvaluator::rescore()
+{
+    if (!lines)
+    {
+        return;
+    }
+    int lineCount = lines->count;
+    for (int player = 0; player < 2; ++player)
+    {
+        fill(count[player].begin(), count[player].end(), 0);
+        fill(nearWin[player].begin(), nearWin[player].end(), 0);
+        fill(nearFork[player].begin(), nearFork[player].end(), 0);
+        winningCells[player] = 0;
+        forkCells[player] = 0;
+    }
+    for (int line = 0; line < lineCount; ++line)
+    {
+        for (int i = 0; i < lines->length; ++i)
+        {
+            int mark = cells[lines->cells[line * lines->length + i]];
+            if (mark != 0)
+                count[mark - 1][line]++;
+        }
+    }
+
+    // Open-line histogram: one branchless pass over the line counts per mark count, which the
+    // compiler turns into wide byte compares
+    const uint8_t *x = count[0].data();
+    const uint8_t *o = count[1].data();
+    for (int marks = 1; marks <= length; ++marks)
+    {
+        int xOpen = 0, oOpen = 0;
+        for (int line = 0; line < lineCount; ++line)
+        {
+            xOpen += (x[line] == marks) & (o[line] == 0);
+            oOpen += (o[line] == marks) & (x[line] == 0);
+        }
+        open[0][marks] = xOpen;
+        open[1][marks] = oOpen;
+    }
+
+    for (int line = 0; line < lineCount; ++line)
+    {
+        if ((x[line] > 0) == (o[line] > 0))
+            continue; // empty or blocked
+        int owner = x[line] > 0 ? 0 : 1;
+        int marks = count[owner][line];
+        vector<uint8_t> *counter = marks == length - 1 ? &nearWin[owner] : marks == length - 2 ? &nearFork[owner] : nullptr;
+        if (!counter)
+            continue;
+        for (int i = 0; i < lines->length; ++i)
+            (*counter)[lines->cells[line * lines->length + i]]++;
+    }
+    for (int cell = 0; cell < static_cast<int>(cells.size()); ++cell)
+    {
+        if (cells[cell] == 0)
+            setCellEmpty(cell, true);
+    }
+}
+
+/**
+ * @brief Scores the position for the side to move.
+ *
+ * A completed line, or a threat the side to move can complete, scores PATTERN_WIN; two threats
+ * of the opponent cannot both be blocked. Otherwise the result is the weighted pattern score of
+ * the side to move (scaled by the tempo weight) minus that of the opponent.
+ *
+ * @param toMove 0 if X is to move, 1 if O is.
+ * @return The score from the point of view of the side to move.
+ */
+int PatternEvaluator::evaluate(int toMove) const
+{
+    if (!lines)
+    {
+        return 0;
+    }
+    int opponent = 1 - toMove;
+    if (hasWon(opponent))
+        return -PATTERN_WIN;
+    if (hasWon(toMove))
+        return PATTERN_WIN;
+    if (winningCells[toMove] > 0)
+        return PATTERN_WIN - 1;
+    if (winningCells[opponent] > 1)
+        return -(PATTERN_WIN - 2);
+    return playerScore(toMove) * weights->tempo / 100 - playerScore(opponent);
+}
+
+/**
+ * @brief Returns the weighted pattern score of one player.
+ */
+int PatternEvaluator::playerScore(int player) const
+{
+    int score = 0;
+    for (int marks = 1; marks < length - 1; ++marks)
+        score += weights->line[marks] * open[player][marks];
+    score += weights->threat * open[player][length - 1];
+    score += weights->fork * forkCells[player];
+    return score;
+}
+
+/**
+ * @brief Adds (delta = 1) or removes (delta = -1) a line from the counts of its current state.
+ */
+void PatternEvaluator::applyLine(int line, int delta)
+{
+    int x = count[0][line], o = count[1][line];
+    if ((x > 0) == (o > 0))
+    {
+        return; // empty lines are not counted and blocked lines are worth nothing
+    }
+    int owner = x > 0 ? 0 : 1;
+    int marks = x > 0 ? x : o;
+    open[owner][marks] += delta;
+    if (marks == length - 1)
+        adjustCells(nearWin[owner], line, delta, winningCells[owner], 1);
+    else if (marks == length - 2)
+        adjustCells(nearFork[owner], line, delta, forkCells[owner], 2);
+}
+
+/**
+ * @brief Updates a per-cell line counter over one line, keeping the tally of empty cells whose
+ *        counter is at least `threshold` in step.
+ */
+void PatternEvaluator::adjustCells(vector<uint8_t> &counter, int line, int delta, int &tally, int threshold)
+{
+    const int *lineCells = &lines->cells[line * lines->length];
+    for (int i = 0; i < lines->length; ++i)
+    {
+        int cell = lineCells[i];
+        int before = counter[cell];
+        counter[cell] = static_cast<uint8_t>(before + delta);
+        if (cells[cell] != 0)
+            continue; // occupied cells keep their counters but are not tallied
+        tally += (before + delta >= threshold) - (before >= threshold);
+    }
+}
+
+/**
+ * @brief Adds a cell to, or removes it from, the threat and fork tallies as it empties or fills.
+ */
+void PatternEvaluator::setCellEmpty(int cell, bool empty)
+{
+    int delta = empty ? 1 : -1;
+    for (int player = 0; player < 2; ++player)
+    {
+        if (nearWin[player][cell] >= 1)
+            winningCells[player] += delta;
+        if (nearFork[player][cell] >= 2)
+            forkCells[player] += delta;
+    }
+}
@@ -1,75 +1,114 @@
 /*
 Author: Arina Shah
 Class: ECE4122 (A)
-Last Date Modified: 12/3/2024
+Last Date Modified: 10/19/2026
 Description:
 This file implements the core game logic for Tic Tac Toe. It includes functions to manage
 the game state, update the grid, check for game-over conditions, serialize/deserialize the
-game state for multiplayer mode, and implement AI moves for single-player mode.
+game state for multiplayer mode, and implement AI moves for single-player mode. Drawing the
+board lives in graphics.cpp so the game logic can be used without a window.
 */
 
 #include "game.hpp"
+#include "cache.hpp"
+#include "ultimate.hpp"
+#include "qubic.hpp"
+#include "metrics.hpp"
+#include <algorithm>
+#include <bitset>
 #include <map>
 
 /**
- * @brief Draws the game board and current state of the grid.
+ * @brief Sets the board variant and resizes the grid to match it.
+ *
+ * @param variant The board variant (CLASSIC or GOMOKU).
+ * This function clears the grid, so it should only be called before the game starts.
  */
-void Game::drawBoard()
+void Game::setVariant(VARIANT variant)
 {
-
-    window.clear(Color::White);
-
-    // Draw the Tic-Tac-Toe grid
-    RectangleShape line;
-
-    // Vertical lines
-    for (int i = 1; i < 3; ++i)
+    this->variant = variant;
+    if (variant == GOMOKU)
     {
-        line.setSize(Vector2f(5, windowHeight));
-        line.setPosition(i * cellSize, statusBarHeight);
-        line.setFillColor(Color::Black);
-        window.draw(line);
+        rows = gomokuSize;
+        cols = gomokuSize;
+        winLength = gomokuWinLength;
     }
-
-    // Horizontal lines
-    for (int i = 1; i < 3; ++i)
+    else if (variant == ULTIMATE)
+    {
+        rows = 9;
+        cols = 9;
+        winLength = 3;
+    }
+    else if (variant == QUBIC)
     {
-        line.setSize(Vector2f(windowWidth, 5));
-        line.setPosition(0, i * cellSize + statusBarHeight);
-        line.setFillColor(Color::Black);
-        window.draw(line);
+        rows = 8; // four 4x4 layers arranged 2x2
+        cols = 8;
+        winLength = 4;
     }
+    else
+    {
+        rows = 3;
+        cols = 3;
+        winLength = 3;
+    }
+    lines = &getLineTable(rows, cols, winLength);
+    grid.assign(rows, vector<int>(cols, 0));
+    resetEmptyCells();
 
-    Text text;
+    // Only the Gomoku board is searched with the pattern evaluator; on the other boards the copies
+    // made at every minimax node stay as cheap as before
+    if (variant == GOMOKU)
+        evaluator.reset(*lines);
+    else
+        evaluator.clear();
+}
 
-    text.setFont(font);
-    text.setCharacterSize(100);
+/**
+ * @brief Marks every cell of the board empty in the cell bitmask.
+ */
+void Game::resetEmptyCells()
+{
+    int cells = rows * cols;
+    for (int word = 0; word < BOARD_MASK_WORDS; ++word)
+    {
+        int bits = min(max(cells - 64 * word, 0), 64);
+        emptyCells[word] = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+    }
+}
 
-    // Draw X's and O's in correct positions
-    for (int row = 0; row < 3; ++row)
+/**
+ * @brief Builds the bitmask of cells the player to move may play, without scanning the grid.
+ *
+ * @param mask Receives bit (row * cols + col) for each legal cell.
+ * @return The number of legal cells.
+ */
+int Game::legalMoveMask(uint64_t mask[BOARD_MASK_WORDS]) const
+{
+    copy(begin(emptyCells), end(emptyCells), mask);
+    if (variant == ULTIMATE && status == PLAYING) // keep only the sub-boards open to the player
     {
-        for (int col = 0; col < 3; ++col)
+        UltimateBoard board = UltimateBoard::fromGame(*this);
+        for (int word = 0; word < BOARD_MASK_WORDS; ++word)
+            mask[word] = 0;
+        int moves[81];
+        int count = board.legalMoves(moves);
+        for (int i = 0; i < count; ++i)
         {
-            if (grid[row][col] == 1)
-            { // Draw X
-                text.setString("X");
-                text.setFillColor(Color::Red);
-                FloatRect textBounds = text.getLocalBounds();
-                text.setOrigin(textBounds.left + textBounds.width / 2.0f, textBounds.top + textBounds.height / 2.0f);
-                text.setPosition(col * cellSize + cellSize / 2.0f, row * cellSize + cellSize / 2.0f + statusBarHeight);
-                window.draw(text);
-            }
-            else if (grid[row][col] == 2)
-            { // Draw O
-                text.setString("O");
-                text.setFillColor(Color::Blue);
-                FloatRect textBounds = text.getLocalBounds();
-                text.setOrigin(textBounds.left + textBounds.width / 2.0f, textBounds.top + textBounds.height / 2.0f);
-                text.setPosition(col * cellSize + cellSize / 2.0f, row * cellSize + cellSize / 2.0f + statusBarHeight);
-                window.draw(text);
-            }
+            pair<int, int> cell = ultimateMoveCell(moves[i]);
+            int index = cell.first * cols + cell.second;
+            mask[index / 64] |= 1ULL << (index % 64);
         }
     }
+    else if (status != PLAYING)
+    {
+        for (int word = 0; word < BOARD_MASK_WORDS; ++word)
+            mask[word] = 0;
+    }
+
+    int count = 0;
+    for (int word = 0; word < BOARD_MASK_WORDS; ++word)
+        count += static_cast<int>(bitset<64>(mask[word]).count());
+    return count;
 }
 
 /**
@@ -83,49 +122,66 @@ bool Game::checkEmptyCell(int row, int col) {
     return grid[row][col] == 0;
 }
 
+/**
+ * @brief Checks if the player to move may play in a specific cell.
+ * 
+ * @param row The row index of the cell.
+ * @param col The column index of the cell.
+ * @return True if the cell is empty and, in Ultimate, lies in a sub-board that is open to the player.
+ */
+bool Game::isLegalMove(int row, int col) {
+    if (variant == ULTIMATE) {
+        return UltimateBoard::fromGame(*this).isLegal(ultimateMoveIndex(row, col));
+    }
+    return checkEmptyCell(row, col);
+}
+
 /**
  * @brief Updates the game status by checking for a win, draw, or ongoing game.
  * 
- * This function checks each row, column, and diagonal for a win condition.
- * If no winner is found and all cells are filled, the game is a draw. Otherwise,
- * the game continues.
+ * This function checks each winning line (rows, columns and diagonals of `winLength`
+ * cells) for a win condition. If no winner is found and all cells are filled, the
+ * game is a draw. Otherwise, the game continues.
  */
 void Game::updateGameStatus()
 {
-    // Check rows and columns for a win
-    for (int i = 0; i < 3; ++i)
+    // Ultimate decides the winner from the sub-boards, and Qubic from the lines of the cube
+    if (variant == ULTIMATE)
     {
-        // Check row
-        if (grid[i][0] != 0 && grid[i][0] == grid[i][1] && grid[i][1] == grid[i][2])
-        {
-            status = grid[i][0] == 1 ? X_WIN : O_WIN;
-            return;
-        }
-        // Check column
-        if (grid[0][i] != 0 && grid[0][i] == grid[1][i] && grid[1][i] == grid[2][i])
-        {
-            status = grid[0][i] == 1 ? X_WIN : O_WIN;
-            return;
-        }
+        status = UltimateBoard::fromGame(*this).status;
+        return;
     }
-
-    // Check diagonals for a win
-    if (grid[0][0] != 0 && grid[0][0] == grid[1][1] && grid[1][1] == grid[2][2])
+    if (variant == QUBIC)
     {
-        status = grid[0][0] == 1 ? X_WIN : O_WIN;
+        status = QubicBoard::fromGame(*this).status;
         return;
     }
-    if (grid[0][2] != 0 && grid[0][2] == grid[1][1] && grid[1][1] == grid[2][0])
+
+    // Check every line for a win
+    const int *lineCells = lines->cells.data();
+    for (int line = 0; line < lines->count; ++line, lineCells += winLength)
     {
-        status = grid[0][2] == 1 ? X_WIN : O_WIN;
-        return;
+        int first = grid[lineCells[0] / cols][lineCells[0] % cols];
+        if (first == 0)
+            continue;
+
+        bool won = true;
+        for (int i = 1; i < winLength && won; ++i)
+        {
+            won = grid[lineCells[i] / cols][lineCells[i] % cols] == first;
+        }
+        if (won)
+        {
+            status = first == 1 ? X_WIN : O_WIN;
+            return;
+        }
     }
 
     // Check for a draw (if all cells are filled and no one has won)
     bool isDraw = true;
-    for (int row = 0; row < 3; ++row)
+    for (int row = 0; row < rows; ++row)
     {
-        for (int col = 0; col < 3; ++col)
+        for (int col = 0; col < cols; ++col)
         {
             if (grid[row][col] == 0)
             {
@@ -154,14 +210,18 @@ void Game::updateGameStatus()
  * @param row The row index of the move.
  * @param col The column index of the move.
  * 
- * This function updates the grid with the player's symbol (X or O) if the cell is empty.
- * It then switches the turn to the other player and updates the game status.
+ * This function updates the grid with the player's symbol (X or O) if the move is legal.
+ * It then records the move, switches the turn to the other player and updates the game status.
  */
 void Game::playerMove(int row, int col)
 {
-    if (grid[row][col] == 0)
+    if (isLegalMove(row, col))
     {
         grid[row][col] = (activeTurn == X) ? 1 : 2; // 1 for X, 2 for O
+        int index = row * cols + col;
+        emptyCells[index / 64] &= ~(1ULL << (index % 64));
+        evaluator.play(index, activeTurn == X ? 0 : 1);
+        lastMove = {row, col};
         activeTurn = (activeTurn == X) ? O : X; // End turn
     }
     updateGameStatus();
@@ -175,7 +235,6 @@ void Game::playerMove(int row, int col)
  */
 void Game::resetGame()
 {
-    window.clear(Color::White);
     for (auto &row : grid)
     {
         for (auto &cell : row)
@@ -183,9 +242,49 @@ void Game::resetGame()
             cell = 0; // Set each cell to empty
         }
     }
+    resetEmptyCells();
+    if (evaluator.active())
+        evaluator.reset(*lines);
+    lastMove = {-1, -1};
     status = PLAYING; // Reset status to playing
 }
 
+/**
+ * @brief Estimates the value of a position that may still be in play, for depth-limited searches.
+ *
+ * @param player The player (X or O) from whose point of view the position is scored.
+ * @return PATTERN_WIN for a won game, -PATTERN_WIN for a lost one, 0 for a draw, and otherwise
+ *         the pattern evaluation (open lines, threats and forks) of the classic or Gomoku board.
+ *         Ultimate and Qubic positions still in play score 0.
+ */
+int Game::evaluate(PLAYER player) const
+{
+    if (status != PLAYING)
+    {
+        if (status == DRAW)
+            return 0;
+        return (status == X_WIN) == (player == X) ? PATTERN_WIN : -PATTERN_WIN;
+    }
+    if (variant != CLASSIC && variant != GOMOKU)
+    {
+        return 0;
+    }
+
+    int toMove = activeTurn == X ? 0 : 1;
+    int value;
+    if (evaluator.active())
+    {
+        value = evaluator.evaluate(toMove);
+    }
+    else
+    {
+        PatternEvaluator scratch(*lines); // the classic board is small enough to count from scratch
+        scratch.setBoard(grid);
+        value = scratch.evaluate(toMove);
+    }
+    return player == activeTurn ? value : -value;
+}
+
 /**
  * @brief Calculates the score for the current game state based on the specified player.
  * 
@@ -216,13 +315,25 @@ int Game::score(PLAYER player) {
  * @return The score of the optimal move.
  * 
  * This function recursively evaluates all possible game states to find the best move
- * for the computer. It uses the `score` function to evaluate terminal states.
+ * for the computer. It uses the `score` function to evaluate terminal states. Results are
+ * stored in the evaluation cache, so positions that were already searched (in this run or,
+ * with a warm-started cache, a previous one) are answered without searching again.
  */
 int minimax(Game game, pair<int, int>& move, PLAYER computer)
 {
+    countMetric(MINIMAX_NODES);
+
     if (game.status != PLAYING) {
         return game.score(computer);
     }
+
+    uint64_t key = game.key();
+    CacheEntry cached;
+    if (evaluationCache.lookup(key, cached)) {
+        move = {cached.row, cached.col};
+        return computer == X ? cached.score : -cached.score;
+    }
+
     vector<int> scores;
     vector<pair<int, int>> moves;
     vector<pair<int, int>> availableMoves = game.availablePositions();
@@ -234,18 +345,17 @@ int minimax(Game game, pair<int, int>& move, PLAYER computer)
         moves.push_back(currentMove);
     }
 
+    int bestIndex;
     if (game.activeTurn == computer) {
-        auto it = max_element(scores.begin(), scores.end());
-        int maxScoreIndex = distance(scores.begin(), it);
-        move = moves[maxScoreIndex];
-        return scores[maxScoreIndex];
+        bestIndex = distance(scores.begin(), max_element(scores.begin(), scores.end()));
     } else {
-        auto it = min_element(scores.begin(), scores.end());
-        int minScoreIndex = distance(scores.begin(), it);
-        move = moves[minScoreIndex];
-        return scores[minScoreIndex];
+        bestIndex = distance(scores.begin(), min_element(scores.begin(), scores.end()));
     }
+    move = moves[bestIndex];
 
+    int xScore = computer == X ? scores[bestIndex] : -scores[bestIndex];
+    evaluationCache.store(key, {xScore, move.first, move.second});
+    return scores[bestIndex];
 }
 
 /**
@@ -261,12 +371,15 @@ Game Game::getNewState(pair<int, int> move) {
 /**
  * @brief Serializes the game state into a string for network transmission.
  * 
- * The serialized string includes the grid, active turn, game status, mode, and difficulty.
+ * The serialized string includes the variant, grid, active turn, game status, mode, difficulty, and last move.
  * @return A string representation of the game state.
  */
 string Game::serialize() const {
     ostringstream oss;
 
+    // Serialize the variant first so the receiver can size its grid
+    oss << variant << " ";
+
     // Serialize the grid
     for (const auto& row : grid) {
         for (int cell : row) {
@@ -277,6 +390,9 @@ string Game::serialize() const {
     // Serialize activeTurn, status, mode, and difficulty
     oss << activeTurn << " " << status << " " << mode << " " << difficulty;
 
+    // Serialize the last move (decides the next sub-board in Ultimate)
+    oss << " " << lastMove.first << " " << lastMove.second;
+
     return oss.str(); // Return the serialized string
 }
 
@@ -284,17 +400,28 @@ string Game::serialize() const {
  * @brief Deserializes a string to reconstruct the game state.
  * 
  * @param data The string representation of the game state.
- * This function extracts the grid, active turn, game status, mode, and difficulty from the string.
+ * This function extracts the variant, grid, active turn, game status, mode, difficulty, and last move from the string.
  */
 void Game::deserialize(const string& data) {
     istringstream iss(data);
 
-    // Deserialize the grid
-    for (auto& row : grid) {
-        for (int& cell : row) {
+    // Deserialize the variant and resize the grid to match
+    int gameVariant;
+    iss >> gameVariant;
+    setVariant(static_cast<VARIANT>(gameVariant));
+
+    // Deserialize the grid, keeping the empty-cell mask in step
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            int &cell = grid[row][col];
             iss >> cell; // Read grid values
+            if (cell != 0) {
+                int index = row * cols + col;
+                emptyCells[index / 64] &= ~(1ULL << (index % 64));
+            }
         }
     }
+    evaluator.setBoard(grid);
 
     // Deserialize activeTurn, status, mode, and difficulty
     int turn, gameStatus, gameMode, gameDifficulty;
@@ -303,23 +430,86 @@ void Game::deserialize(const string& data) {
     status = static_cast<GAMESTATUS>(gameStatus);
     mode = static_cast<GAMEMODE>(gameMode);
     difficulty = static_cast<DIFFICULTY>(gameDifficulty);
+
+    // Deserialize the last move
+    iss >> lastMove.first >> lastMove.second;
+}
+
+/**
+ * @brief Sets up a position from its marks, keeping the mode and difficulty.
+ *
+ * @param variant The board variant, which sizes the grid.
+ * @param cells The mark of each cell, row by row (0 empty, 1 X, 2 O).
+ * @param toMove The player to move.
+ * @param lastMove The previous move (decides the next sub-board in Ultimate), or {-1, -1}.
+ * The empty-cell mask and the pattern counts are rebuilt from the marks, and the game status
+ * follows from them.
+ */
+void Game::setPosition(VARIANT variant, const vector<int> &cells, PLAYER toMove, pair<int, int> lastMove)
+{
+    setVariant(variant);
+    for (int cell = 0; cell < rows * cols; ++cell)
+    {
+        grid[cell / cols][cell % cols] = cells[cell];
+        if (cells[cell] != 0)
+            emptyCells[cell / 64] &= ~(1ULL << (cell % 64));
+    }
+    evaluator.setBoard(grid);
+    activeTurn = toMove;
+    this->lastMove = lastMove;
+    status = PLAYING;
+    updateGameStatus();
 }
 
 /**
- * @brief Returns a list of all empty positions on the grid.
+ * @brief Returns a list of all positions the player to move may play.
  * 
- * @return A vector of pairs, each representing the row and column of an empty cell.
+ * @return A vector of pairs, each representing the row and column of a legal cell (every empty
+ *         cell, except in Ultimate where the previous move restricts the sub-board).
  */
 vector<pair<int, int>> Game::availablePositions()
 {
     vector<pair<int, int>> positions;
-    for (int i = 0; i < 3; ++i)
+    if (variant == ULTIMATE) // only cells in the sub-boards open to the player to move
     {
-        for (int j = 0; j < 3; ++j)
+        int moves[81];
+        UltimateBoard board = UltimateBoard::fromGame(*this);
+        int count = board.status == PLAYING ? board.legalMoves(moves) : 0;
+        for (int i = 0; i < count; ++i)
+            positions.push_back(ultimateMoveCell(moves[i]));
+        return positions;
+    }
+    for (int i = 0; i < rows; ++i)
+    {
+        for (int j = 0; j < cols; ++j)
         {
             if (grid[i][j] == 0)
                 positions.push_back({i, j});
         }
     }
     return positions;
+}
+
+/**
+ * @brief Packs the position into a key for the evaluation cache.
+ *
+ * Each cell takes two bits (0 empty, 1 X, 2 O) and the player to move takes the bit above them,
+ * so two positions share a key only if they are identical. Keys are exact for boards of up to
+ * 31 cells, which covers every board minimax is used on.
+ * @return The position key.
+ */
+uint64_t Game::key() const
+{
+    uint64_t packed = 0;
+    int shift = 0;
+    for (const auto &row : grid)
+    {
+        for (int cell : row)
+        {
+            packed |= static_cast<uint64_t>(cell) << shift;
+            shift += 2;
+        }
+    }
+    packed |= static_cast<uint64_t>(activeTurn == O) << shift;
+    return packed;
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 /*
 Author: Arina Shah
 Class: ECE4122 (A)
-Last Date Modified: 12/3/2024
+Last Date Modified: 10/19/2026
 Description:
 This file handles the main graphical elements of the game using SFML. It includes functions for
 drawing the game grid, rendering X and O symbols, displaying the status bar, and showing the
@@ -10,10 +10,176 @@ the status bar height.
 */
 
 #include "graphics.hpp"
+#include "ultimate.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+#include <iomanip>
+#include <sstream>
 
 RenderWindow window(VideoMode(windowWidth, windowHeight + statusBarHeight), "Tic-Tac-Toe");
 Font font;
 Text statusBarText;
+bool showMetricsOverlay = SHOW_METRICS_OVERLAY;
+
+/**
+ * @brief Draws the game board and current state of the grid.
+ */
+void Game::drawBoard()
+{
+    TRACE_SPAN("drawBoard");
+
+    window.clear(Color::White);
+
+    // Cells shrink as the board grows so the whole grid always fills the window
+    float cellWidth = static_cast<float>(windowWidth) / cols;
+    float cellHeight = static_cast<float>(windowHeight) / rows;
+    float thickness = (rows > 3) ? 2.0f : 5.0f;
+
+    // In Ultimate, shade the sub-boards the player to move may play in
+    UltimateBoard ultimate = {};
+    if (variant == ULTIMATE)
+    {
+        ultimate = UltimateBoard::fromGame(*this);
+        RectangleShape highlight(Vector2f(3 * cellWidth, 3 * cellHeight));
+        highlight.setFillColor(Color(255, 240, 170));
+        for (int sub = 0; sub < 9 && status == PLAYING; ++sub)
+        {
+            bool open = !(ultimate.closed & (1 << sub)) && (ultimate.forcedBoard < 0 || ultimate.forcedBoard == sub);
+            if (open)
+            {
+                highlight.setPosition((sub % 3) * 3 * cellWidth, (sub / 3) * 3 * cellHeight + statusBarHeight);
+                window.draw(highlight);
+            }
+        }
+    }
+
+    // Draw the Tic-Tac-Toe grid
+    RectangleShape line;
+
+    // Vertical lines
+    for (int i = 1; i < cols; ++i)
+    {
+        if (variant == ULTIMATE)
+            thickness = (i % 3 == 0) ? 5.0f : 1.0f; // heavy lines between sub-boards
+        else if (variant == QUBIC)
+            thickness = (i == 4) ? 8.0f : 2.0f; // heavy lines between layers
+        line.setSize(Vector2f(thickness, windowHeight));
+        line.setPosition(i * cellWidth, statusBarHeight);
+        line.setFillColor(Color::Black);
+        window.draw(line);
+    }
+
+    // Horizontal lines
+    for (int i = 1; i < rows; ++i)
+    {
+        if (variant == ULTIMATE)
+            thickness = (i % 3 == 0) ? 5.0f : 1.0f;
+        else if (variant == QUBIC)
+            thickness = (i == 4) ? 8.0f : 2.0f;
+        line.setSize(Vector2f(windowWidth, thickness));
+        line.setPosition(0, i * cellHeight + statusBarHeight);
+        line.setFillColor(Color::Black);
+        window.draw(line);
+    }
+
+    Text text;
+
+    text.setFont(font);
+    text.setCharacterSize(static_cast<unsigned>(cellHeight / 2));
+
+    // Draw X's and O's in correct positions
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int col = 0; col < cols; ++col)
+        {
+            if (grid[row][col] == 1)
+            { // Draw X
+                text.setString("X");
+                text.setFillColor(Color::Red);
+                FloatRect textBounds = text.getLocalBounds();
+                text.setOrigin(textBounds.left + textBounds.width / 2.0f, textBounds.top + textBounds.height / 2.0f);
+                text.setPosition(col * cellWidth + cellWidth / 2.0f, row * cellHeight + cellHeight / 2.0f + statusBarHeight);
+                window.draw(text);
+            }
+            else if (grid[row][col] == 2)
+            { // Draw O
+                text.setString("O");
+                text.setFillColor(Color::Blue);
+                FloatRect textBounds = text.getLocalBounds();
+                text.setOrigin(textBounds.left + textBounds.width / 2.0f, textBounds.top + textBounds.height / 2.0f);
+                text.setPosition(col * cellWidth + cellWidth / 2.0f, row * cellHeight + cellHeight / 2.0f + statusBarHeight);
+                window.draw(text);
+            }
+        }
+    }
+
+    // In Ultimate, draw a large faded mark over every sub-board that has been won
+    if (variant == ULTIMATE)
+    {
+        text.setCharacterSize(static_cast<unsigned>(3 * cellHeight * 0.8f));
+        for (int sub = 0; sub < 9; ++sub)
+        {
+            bool xWon = ultimate.won[0] & (1 << sub);
+            bool oWon = ultimate.won[1] & (1 << sub);
+            if (!xWon && !oWon)
+                continue;
+            text.setString(xWon ? "X" : "O");
+            text.setFillColor(xWon ? Color(255, 0, 0, 110) : Color(0, 0, 255, 110));
+            FloatRect textBounds = text.getLocalBounds();
+            text.setOrigin(textBounds.left + textBounds.width / 2.0f, textBounds.top + textBounds.height / 2.0f);
+            text.setPosition((sub % 3 + 0.5f) * 3 * cellWidth, (sub / 3 + 0.5f) * 3 * cellHeight + statusBarHeight);
+            window.draw(text);
+        }
+    }
+
+    // In Qubic, label each 4x4 quadrant with the layer of the cube it shows
+    if (variant == QUBIC)
+    {
+        Text label;
+        label.setFont(font);
+        label.setCharacterSize(14);
+        label.setFillColor(Color(120, 120, 120));
+        for (int layer = 0; layer < 4; ++layer)
+        {
+            label.setString("Layer " + to_string(layer + 1));
+            label.setPosition((layer % 2) * 4 * cellWidth + 6, (layer / 2) * 4 * cellHeight + statusBarHeight + 4);
+            window.draw(label);
+        }
+    }
+}
+
+/**
+ * @brief Rasterizes every glyph the game draws, so the first frames do not stall rendering them.
+ *
+ * SFML renders glyphs into the font's texture on first use for each character size. Menus, the
+ * status bar, the game-over screen, the overlay and the Qubic labels use printable ASCII at fixed
+ * sizes; the X and O marks are sized from each variant's cell height exactly as drawBoard does.
+ */
+void warmGlyphCache()
+{
+    TRACE_SPAN("warmGlyphCache");
+    for (unsigned size : {13u, 14u, 24u, 48u})
+    {
+        for (Uint32 character = ' '; character <= '~'; ++character)
+        {
+            font.getGlyph(character, size, false);
+        }
+    }
+
+    for (VARIANT variant : {CLASSIC, GOMOKU, ULTIMATE, QUBIC})
+    {
+        Game board(NO_MODE, DEFAULT, variant);
+        float cellHeight = static_cast<float>(windowHeight) / board.rows;
+        for (Uint32 mark : {Uint32('X'), Uint32('O')})
+        {
+            font.getGlyph(mark, static_cast<unsigned>(cellHeight / 2), false);
+            if (variant == ULTIMATE)
+            {
+                font.getGlyph(mark, static_cast<unsigned>(3 * cellHeight * 0.8f), false); // won sub-board marks
+            }
+        }
+    }
+}
 
 /**
  * @brief Displays the start screen where the user chooses to play as X or O.
@@ -41,13 +207,14 @@ void displayStartScreen()
 /**
  * @brief Displays the mode choice screen where the user selects Multiplayer or Single Player.
  * 
- * This function renders a message prompting the user to press 1 for Multiplayer or 2 for Single Player.
+ * This function renders a message prompting the user to press 1 for Multiplayer, 2 for Single Player
+ * or 3 to spectate.
  */
 void displayModeChoice()
 {
     Text txt;
     txt.setFont(font);
-    txt.setString("Press 1 for Multiplayer, 2 for Single Player");
+    txt.setString("Press 1 for Multiplayer, 2 for Single Player\n           or 3 to watch a game");
     txt.setCharacterSize(24);
     txt.setFillColor(Color::Black);
 
@@ -63,13 +230,14 @@ void displayModeChoice()
 /**
  * @brief Displays the difficulty choice screen for single-player mode.
  * 
- * This function renders a message prompting the user to press 1 for Easy difficulty or 2 for Hard difficulty.
+ * This function renders a message prompting the user to press 1 for Easy, 2 for Medium, 3 for Hard or 4 for
+ * Expert difficulty.
  */
 void displayDifficultyChoice()
 {
     Text modeText;
     modeText.setFont(font);
-    modeText.setString("Difficulty: Press 1 for Easy, 2 for Hard");
+    modeText.setString("Difficulty: 1 Easy, 2 Medium, 3 Hard, 4 Expert");
     modeText.setCharacterSize(24);
     modeText.setFillColor(Color::Black);
 
@@ -82,11 +250,34 @@ void displayDifficultyChoice()
     window.display();
 }
 
+/**
+ * @brief Displays the board choice screen where the user selects the classic board, Gomoku, Ultimate or Qubic.
+ * 
+ * This function renders a message prompting the user to press 1 for the 3x3 board, 2 for 15x15 Gomoku,
+ * 3 for Ultimate Tic Tac Toe or 4 for 3D Qubic.
+ */
+void displayVariantChoice()
+{
+    Text variantText;
+    variantText.setFont(font);
+    variantText.setString("Board: 1 3x3, 2 Gomoku, 3 Ultimate, 4 3D Qubic");
+    variantText.setCharacterSize(24);
+    variantText.setFillColor(Color::Black);
+
+    FloatRect textBounds = variantText.getLocalBounds();
+    variantText.setOrigin(textBounds.width / 2.0f, textBounds.height / 2.0f);
+    variantText.setPosition(windowWidth / 2.0f, windowHeight / 2.0f);
+
+    window.clear(Color::White);
+    window.draw(variantText);
+    window.display();
+}
+
 /**
  * @brief Displays the game-over screen with the outcome and a prompt to restart the game.
  * 
  * @param gameOver The final game status (X_WIN, O_WIN, or DRAW).
- * @param player The player type (X or O) to customize the message.
+ * @param player The player type (X or O) to customize the message, or NONE for a spectator.
  * 
  * This function displays the outcome of the game. It also prompts the user to press R to restart the game.
  */
@@ -100,7 +291,11 @@ void gameOverScreen(GAMESTATUS gameOver, PLAYER player)
     message.setCharacterSize(48);
     message.setFillColor(Color::White);
 
-    if (gameOver == X_WIN)
+    if (player == NONE && gameOver != DRAW)
+    {
+        message.setString(gameOver == X_WIN ? "X Wins!" : "O Wins!");
+    }
+    else if (gameOver == X_WIN)
     {
         message.setString(player == X ? "You Win (X)!" : "Opponent Wins (X)");
     }
@@ -121,7 +316,7 @@ void gameOverScreen(GAMESTATUS gameOver, PLAYER player)
     restartMessage.setFont(font);
     restartMessage.setCharacterSize(24);
     restartMessage.setFillColor(Color::White);
-    restartMessage.setString("Press R to Restart");
+    restartMessage.setString(player == NONE ? "Waiting for the next game" : "Press R to Restart");
 
     FloatRect restartBounds = restartMessage.getLocalBounds();
     restartMessage.setOrigin(restartBounds.width / 2.0f, restartBounds.height / 2.0f);
@@ -149,19 +344,32 @@ void initStatusBar() {
 /**
  * @brief Updates the status bar text with the current game mode, active turn, and difficulty level.
  * 
- * @param mode The current game mode (SINGLE_PLAYER or MULTIPLAYER).
+ * @param mode The current game mode (SINGLE_PLAYER, MULTIPLAYER or SPECTATOR).
  * @param activeTurn The current active player's turn (X or O).
- * @param difficulty The difficulty level (EASY or HARD) for single-player mode.
+ * @param difficulty The difficulty level (EASY, MEDIUM, HARD or EXPERT) for single-player mode.
+ * @param variant The board variant; Ultimate and Qubic are named in place of the single-player mode.
  * 
  * This function updates the text displayed on the status bar with the latest game state.
  */
-void updateStatusBar(GAMEMODE mode, PLAYER activeTurn, DIFFICULTY difficulty) {
+void updateStatusBar(GAMEMODE mode, PLAYER activeTurn, DIFFICULTY difficulty, VARIANT variant) {
     string modeText = (mode == SINGLE_PLAYER) ? "Single Player" : "Multiplayer";
+    if (variant == ULTIMATE) {
+        modeText = (mode == SINGLE_PLAYER) ? "Ultimate" : "Ultimate Multiplayer";
+    }
+    else if (variant == QUBIC) {
+        modeText = (mode == SINGLE_PLAYER) ? "3D Qubic" : "3D Qubic Multiplayer";
+    }
+    if (mode == SPECTATOR) {
+        modeText = "Spectating";
+    }
     string turnText = (activeTurn == X) ? "Turn: X" : "Turn: O";
 
     string difficultyText = "";
     if (mode == SINGLE_PLAYER) {
-        difficultyText = (difficulty == EASY) ? " | Difficulty: Easy" : " | Difficulty: Hard";
+        if (difficulty == EASY) difficultyText = " | Difficulty: Easy";
+        else if (difficulty == MEDIUM) difficultyText = " | Difficulty: Medium";
+        else if (difficulty == HARD) difficultyText = " | Difficulty: Hard";
+        else difficultyText = " | Difficulty: Expert";
     }
 
     statusBarText.setString(modeText + " | " + turnText + difficultyText);
@@ -175,8 +383,53 @@ void updateStatusBar(GAMEMODE mode, PLAYER activeTurn, DIFFICULTY difficulty) {
  * This function updates the status bar, renders the game grid, and displays the entire window.
  */
 void drawGame(Game game) {
-    updateStatusBar(game.mode, game.activeTurn, game.difficulty);
+    TRACE_SPAN("drawGame");
+    ScopedLatency frameTime(FRAME_TIME);
+    countMetric(FRAMES_DRAWN);
+    updateStatusBar(game.mode, game.activeTurn, game.difficulty, game.variant);
     game.drawBoard();
     window.draw(statusBarText);
+    if (showMetricsOverlay) {
+        drawMetricsOverlay();
+    }
     window.display();
+}
+
+/**
+ * @brief Draws the debug overlay with latency percentiles and search counters below the status bar.
+ */
+void drawMetricsOverlay() {
+    MetricsSnapshot snapshot = collectMetrics();
+
+    // p50 / p99 / max in milliseconds for one histogram
+    auto latency = [&snapshot](const char *label, HISTOGRAM histogram) {
+        const HistogramSnapshot &h = snapshot.histograms[histogram];
+        ostringstream line;
+        line << fixed << setprecision(2) << label << " p50 " << h.percentile(0.5) / 1000.0 << " p99 "
+             << h.percentile(0.99) / 1000.0 << " max " << h.max / 1000.0 << " ms (" << h.count << ")\n";
+        return line.str();
+    };
+
+    string text = latency("AI think", AI_THINK_TIME) + latency("Round trip", NETWORK_ROUND_TRIP) +
+                  latency("Frame", FRAME_TIME) + latency("Input to photon", INPUT_TO_PHOTON);
+    text += "Nodes: minimax " + to_string(snapshot.counters[MINIMAX_NODES]) + ", solver " +
+            to_string(snapshot.counters[SOLVER_NODES]) + ", playouts " + to_string(snapshot.counters[MCTS_PLAYOUTS]) +
+            ", qubic " + to_string(snapshot.counters[QUBIC_NODES]) + "\n";
+    text += "Network: " + to_string(snapshot.counters[NETWORK_BYTES_SENT]) + " B sent, " +
+            to_string(snapshot.counters[NETWORK_BYTES_RECEIVED]) + " B received";
+
+    Text overlayText;
+    overlayText.setFont(font);
+    overlayText.setCharacterSize(13);
+    overlayText.setFillColor(Color::White);
+    overlayText.setString(text);
+    overlayText.setPosition(8, statusBarHeight + 6);
+
+    FloatRect bounds = overlayText.getGlobalBounds();
+    RectangleShape background(Vector2f(bounds.width + 12, bounds.height + 12));
+    background.setPosition(2, statusBarHeight);
+    background.setFillColor(Color(0, 0, 0, 170));
+
+    window.draw(background);
+    window.draw(overlayText);
 }
\ No newline at end of file
@@ -0,0 +1,93 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This file builds the winning-line tables for each board shape. Tables are built once per shape
+on first use and shared by every game, search thread and evaluator afterwards.
+*/
+
+#include "lines.hpp"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+namespace
+{
+/**
+ * @brief Appends one line starting at (row, col) and stepping by (dRow, dCol).
+ */
+void addLine(LineTable &table, int row, int col, int dRow, int dCol)
+{
+    int line = table.count++;
+    for (int i = 0; i < table.length; ++i)
+    {
+        int cell = (row + i * dRow) * table.cols + (col + i * dCol);
+        table.cells.push_back(cell);
+        table.linesByCell[cell].push_back(line);
+    }
+}
+
+/**
+ * @brief Builds the line table for a board shape.
+ *
+ * Lines are ordered row i, column i (for each i), then diagonals, then anti-diagonals. On the
+ * 3x3 board this is the same order the original hand-written win check used, so the first
+ * completed line found is the same one it found.
+ */
+unique_ptr<LineTable> buildLineTable(int rows, int cols, int length)
+{
+    unique_ptr<LineTable> table(new LineTable());
+    table->rows = rows;
+    table->cols = cols;
+    table->length = length;
+    table->count = 0;
+    table->linesByCell.resize(rows * cols);
+
+    for (int i = 0; i < max(rows, cols); ++i)
+    {
+        if (i < rows)
+        {
+            for (int col = 0; col + length <= cols; ++col)
+                addLine(*table, i, col, 0, 1); // row
+        }
+        if (i < cols)
+        {
+            for (int row = 0; row + length <= rows; ++row)
+                addLine(*table, row, i, 1, 0); // column
+        }
+    }
+    for (int row = 0; row + length <= rows; ++row)
+    {
+        for (int col = 0; col + length <= cols; ++col)
+            addLine(*table, row, col, 1, 1); // diagonal
+    }
+    for (int row = 0; row + length <= rows; ++row)
+    {
+        for (int col = length - 1; col < cols; ++col)
+            addLine(*table, row, col, 1, -1); // anti-diagonal
+    }
+    return table;
+}
+}
+
+/**
+ * @brief Returns the shared line table for a board shape, building it on first use.
+ *
+ * @param rows Number of board rows.
+ * @param cols Number of board columns.
+ * @param length Number of marks in a row needed to win.
+ * @return A reference to the table, valid for the lifetime of the program.
+ */
+const LineTable &getLineTable(int rows, int cols, int length)
+{
+    static mutex tablesLock;
+    static map<tuple<int, int, int>, unique_ptr<LineTable>> tables;
+
+    lock_guard<mutex> guard(tablesLock);
+    unique_ptr<LineTable> &table = tables[make_tuple(rows, cols, length)];
+    if (!table)
+        table = buildLineTable(rows, cols, length);
+    return *table;
+}
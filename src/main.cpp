@@ -1,7 +1,7 @@
 /*
 Author: Arina Shah
 Class: ECE4122 (A)
-Last Date Modified: 12/3/2024
+Last Date Modified: 10/19/2026
 Description:
 This is the main entry point for the Tic Tac Toe game. It handles the game setup, user input,
 game modes (Single Player or Multiplayer), and the main game loop. It integrates the logic
@@ -14,6 +14,13 @@ and managing turn-based gameplay.
 #include "game.hpp"
 #include "network.hpp"
 #include "graphics.hpp"
+#include "cache.hpp"
+#include "ai.hpp"
+#include "spectator.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+#include "assets.hpp"
+#include <cstdlib>
 #include <thread>
 #include <chrono>
 
@@ -22,18 +29,37 @@ using namespace std;
 
 int main()
 {
-    if (!font.loadFromFile("assets/Roboto-Regular.ttf"))
+    uint64_t launchedAt = metricsClockMicros(); // startup and first-frame times are measured from here
+    bool firstFrameShown = false;
+
+    startMetricsDump(METRICS_FILE, METRICS_DUMP_SECONDS);
+    if (TRACE_ENABLED || getenv("TICTACTOE_TRACE"))
+    {
+        startTracing(TRACE_FILE_PREFIX);
+        setTraceThreadName("main");
+    }
+
+    // The font is compiled into the executable; the assets folder is only a fallback
+    if (!font.loadFromMemory(embeddedFont, embeddedFontSize) && !font.loadFromFile("assets/Roboto-Regular.ttf"))
     {
         cerr << "Failed to load font!" << endl;
         return -1;
     }
+    warmGlyphCache();
 
     srand(time(nullptr));
 
+    loadEvaluationCache(); // warm-start the minimax cache from the previous run
+    loadEvalWeights(EVAL_WEIGHTS_FILE, evalWeights);
+
+    uint64_t startup = metricsClockMicros() - launchedAt;
+    recordLatency(STARTUP_TIME, startup);
+
     PLAYER player = NONE;
     PLAYER computer = NONE;
     GAMEMODE mode = NO_MODE;
     DIFFICULTY difficulty = DEFAULT;
+    VARIANT variant = CLASSIC;
     Game game;
 
     while (window.isOpen())
@@ -44,6 +70,14 @@ int main()
         if (mode == NO_MODE)
         {
             displayModeChoice();
+            if (!firstFrameShown)
+            {
+                firstFrameShown = true;
+                uint64_t firstFrame = metricsClockMicros() - launchedAt;
+                recordLatency(FIRST_FRAME_TIME, firstFrame);
+                cout << "Startup " << startup / 1000.0 << " ms, first frame "
+                     << firstFrame / 1000.0 << " ms" << endl;
+            }
             while (1)
             {
                 if (Keyboard::isKeyPressed(Keyboard::Num1))
@@ -56,6 +90,20 @@ int main()
                     mode = SINGLE_PLAYER;
                     break;
                 }
+                else if (Keyboard::isKeyPressed(Keyboard::Num3))
+                {
+                    mode = SPECTATOR;
+                    break;
+                }
+            }
+
+            // Spectators only watch; go back to the menu when the host goes away
+            if (mode == SPECTATOR)
+            {
+                watchGame();
+                mode = NO_MODE;
+                this_thread::sleep_for(chrono::milliseconds(250));
+                continue;
             }
 
             // Choose difficulty of computer if playing single player game
@@ -71,10 +119,20 @@ int main()
                         break;
                     }
                     else if (Keyboard::isKeyPressed(Keyboard::Num2))
+                    {
+                        difficulty = MEDIUM;
+                        break;
+                    }
+                    else if (Keyboard::isKeyPressed(Keyboard::Num3))
                     {
                         difficulty = HARD;
                         break;
                     }
+                    else if (Keyboard::isKeyPressed(Keyboard::Num4))
+                    {
+                        difficulty = EXPERT;
+                        break;
+                    }
                 }
             }
         }
@@ -91,6 +149,7 @@ int main()
                     if (event.type == Event::Closed)
                     {
                         window.close();
+                        saveEvaluationCache();
                         return 0;
                     }
                 }
@@ -106,19 +165,51 @@ int main()
                 }
             }
 
+            // Choose the board, unless this is the multiplayer client (it receives the board from the server)
+            if (mode == SINGLE_PLAYER || player == X)
+            {
+                this_thread::sleep_for(chrono::milliseconds(250));
+                displayVariantChoice();
+                while (1)
+                {
+                    if (Keyboard::isKeyPressed(Keyboard::Num1))
+                    {
+                        variant = CLASSIC;
+                        break;
+                    }
+                    else if (Keyboard::isKeyPressed(Keyboard::Num2))
+                    {
+                        variant = GOMOKU;
+                        break;
+                    }
+                    else if (Keyboard::isKeyPressed(Keyboard::Num3))
+                    {
+                        variant = ULTIMATE;
+                        break;
+                    }
+                    else if (Keyboard::isKeyPressed(Keyboard::Num4))
+                    {
+                        variant = QUBIC;
+                        break;
+                    }
+                }
+            }
+
             if (mode == SINGLE_PLAYER)
             {
                 if (player == X) computer = O;
                 else if (player == O) computer = X;
-                game = Game(mode, difficulty); // shared between user and computer
+                game = Game(mode, difficulty, variant); // shared between user and computer
+                startSpectatorHub();
             }
             else if (mode == MULTIPLAYER)
             {
                 if (player == X)
                 {
                     setupServer();
-                    game = Game(mode, difficulty); // if multiplayer game, player X (server) creates the game and sends it to O (client)
+                    game = Game(mode, difficulty, variant); // if multiplayer game, player X (server) creates the game and sends it to O (client)
                     sendGame(game);
+                    startSpectatorHub(); // the server owns the game, so it also serves spectators
                 }
                 else if (player == O)
                 {
@@ -132,26 +223,42 @@ int main()
 
         // draw initial state
         drawGame(game);
+        broadcastGame(game);
 
         while (game.status == PLAYING)
         {
+            uint64_t clickedAt = 0; // when this turn's click arrived, for the input-to-photon latency
+            bool movePending = false; // this player's move is shown but not yet confirmed by the opponent
+            bool opponentMoved = false; // the opponent's move arrived and has to be echoed back
+            Game confirmed; // state before the pending move
+            pair<int, int> pendingMove;
+
             while (window.pollEvent(event))
             {
                 if (event.type == Event::Closed)
                 {
                     window.close();
+                    saveEvaluationCache();
                     return 0;
                 }
             }
 
             if (game.activeTurn == player) // if it is this player's turn
             {
+                TRACE_SPAN("wait for click");
                 while (true)
                 {
                     if (window.waitEvent(event))
                     {
+                        if (event.type == Event::KeyPressed && event.key.code == Keyboard::F3) // toggle metrics overlay
+                        {
+                            showMetricsOverlay = !showMetricsOverlay;
+                            drawGame(game);
+                        }
                         if (event.type == Event::MouseButtonPressed && event.mouseButton.button == Mouse::Left) // wait until player clicks a cell
                         {
+                            clickedAt = metricsClockMicros();
+
                             // get mouse position
                             int mouseX = event.mouseButton.x;
                             int mouseY = event.mouseButton.y;
@@ -161,13 +268,18 @@ int main()
                                 mouseY -= statusBarHeight;
 
                                 // Determine the cell clicked
-                                int row = mouseY / cellSize;
-                                int col = mouseX / cellSize;
+                                int row = mouseY * game.rows / windowHeight;
+                                int col = mouseX * game.cols / windowWidth;
 
-                                if (row >= 0 && row < 3 && col >= 0 && col < 3) // check click is within the grid bounds
+                                if (row >= 0 && row < game.rows && col >= 0 && col < game.cols) // check click is within the grid bounds
                                 {
+                                    if (game.mode == MULTIPLAYER && game.isLegalMove(row, col)) // shown now, confirmed by the opponent later
+                                    {
+                                        confirmed = game;
+                                        pendingMove = {row, col};
+                                        movePending = true;
+                                    }
                                     game.playerMove(row, col);
-                                    if (game.mode == MULTIPLAYER) sendGame(game);
                                 }
                                 break;
                             }
@@ -179,54 +291,69 @@ int main()
             {
                 if (game.mode == MULTIPLAYER) // opponent move
                 {
-                    game = receiveGame(); // get most recent version of game from opponent
+                    Game proposed = receiveGame(); // get most recent version of game from opponent
+                    game = (player == X) ? acceptMove(game, proposed) : proposed; // the server checks the client's moves
+                    opponentMoved = true;
                 }
                 else if (game.mode == SINGLE_PLAYER) // computer move
                 {
-                    this_thread::sleep_for(chrono::milliseconds(1000)); //delay for computer move
-
-                    if (game.difficulty == EASY) // easy mode selects random empty cell
-                    {
-                        bool foundEmptyCell = false;
-                        int row, col;
-
-                        while (!foundEmptyCell)
-                        {
-                            row = rand() % 3;
-                            col = rand() % 3;
-                            if (game.checkEmptyCell(row, col))
-                            {
-                                foundEmptyCell = true;
-                            }
-                        }
-                        game.playerMove(row, col);
-                    }
-                    else if (game.difficulty == HARD) // hard mode uses minimax algorithm to find optimal move
                     {
-                        pair<int, int> move;
-                        minimax(game, move, computer);
-                        game.playerMove(move.first, move.second);
+                        TRACE_SPAN("computer move delay");
+                        this_thread::sleep_for(chrono::milliseconds(1000)); //delay for computer move
                     }
+
+                    pair<int, int> move = computerMove(game, computer);
+                    game.playerMove(move.first, move.second);
                 }
             }
 
 
             drawGame(game); //draw new game state
+            if (clickedAt != 0)
+            {
+                recordLatency(INPUT_TO_PHOTON, metricsClockMicros() - clickedAt);
+            }
+            broadcastGame(game); // no-op unless this process hosts spectators
 
 
             if (game.mode == MULTIPLAYER) // sync game state
             {
-                if (game.activeTurn == player)
+                if (movePending)
                 {
-                    sendGame(game); // send game state after the turn
+                    // The move is already on screen; send it and reconcile with the opponent's echo
+                    postGame(game);
+                    while (true)
+                    {
+                        Game echo = receiveGame();
+                        if (player == X)
+                        {
+                            if (echo.serialize() != game.serialize())
+                                cerr << "Opponent's copy of the game differs, keeping ours" << endl;
+                            break; // the server's state is authoritative
+                        }
+
+                        bool resend = false;
+                        Game reconciled = reconcileMove(game, confirmed, pendingMove, echo, resend);
+                        if (reconciled.serialize() != game.serialize())
+                        {
+                            game = reconciled; // roll back to the server's state (and re-apply the move if it still fits)
+                            drawGame(game);
+                        }
+                        if (!resend)
+                            break;
+                        confirmed = echo;
+                        postGame(game);
+                    }
                 }
-                else
+                else if (opponentMoved)
                 {
-                    game = receiveGame(); // receive game state before the next turn
+                    postGame(game); // echo the state back so the opponent can reconcile its move
                 }
             }
         }
 
+        saveEvaluationCache(); // snapshot the cache after every game
+
         this_thread::sleep_for(chrono::milliseconds(500));
 
         // Game Over
@@ -237,6 +364,7 @@ int main()
                 if (event.type == Event::Closed)
                 {
                     window.close();
+                    saveEvaluationCache();
                     return 0;
                 }
             }
@@ -250,5 +378,6 @@ int main()
         game.resetGame();
     }
 
+    saveEvaluationCache();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,410 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This file implements the metrics registry. Every thread that records a metric gets its own block
+of counters and histograms on first use. Only the owning thread writes to it, using relaxed atomic
+stores without read-modify-write, so recording costs a few plain memory operations. Readers sum
+the blocks of all live threads plus the totals left behind by threads that have exited. Gauges
+are levels rather than sums, so they live in one shared array instead. A background thread can write the aggregate to a file in Prometheus text format at a fixed interval.
+*/
+
+#include "metrics.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct ThreadHistogram
+{
+    atomic<uint64_t> buckets[HISTOGRAM_BUCKETS];
+    atomic<uint64_t> count;
+    atomic<uint64_t> sum;
+    atomic<uint64_t> max;
+};
+
+struct ThreadMetrics
+{
+    atomic<uint64_t> counters[COUNTER_COUNT];
+    ThreadHistogram histograms[HISTOGRAM_COUNT];
+};
+
+/**
+ * @brief Adds to a value only ever written by the calling thread (no locked instruction needed).
+ */
+inline void bump(atomic<uint64_t> &value, uint64_t amount)
+{
+    value.store(value.load(memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+/**
+ * @brief Adds one thread's values into a snapshot.
+ */
+void accumulate(MetricsSnapshot &snapshot, const ThreadMetrics &metrics)
+{
+    for (int i = 0; i < COUNTER_COUNT; ++i)
+        snapshot.counters[i] += metrics.counters[i].load(memory_order_relaxed);
+    for (int h = 0; h < HISTOGRAM_COUNT; ++h)
+    {
+        const ThreadHistogram &source = metrics.histograms[h];
+        HistogramSnapshot &target = snapshot.histograms[h];
+        for (int b = 0; b < HISTOGRAM_BUCKETS; ++b)
+            target.buckets[b] += source.buckets[b].load(memory_order_relaxed);
+        target.count += source.count.load(memory_order_relaxed);
+        target.sum += source.sum.load(memory_order_relaxed);
+        target.max = std::max(target.max, source.max.load(memory_order_relaxed));
+    }
+}
+
+struct Registry
+{
+    mutex lock; // guards live and retired
+    vector<ThreadMetrics *> live; // blocks of running threads
+    MetricsSnapshot retired; // totals of threads that have exited
+};
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+/**
+ * @brief Owns a thread's metrics block; folds it into the retired totals when the thread exits.
+ */
+struct ThreadSlot
+{
+    ThreadMetrics *metrics;
+
+    ThreadSlot() : metrics(new ThreadMetrics())
+    {
+        Registry &shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        shared.live.push_back(metrics);
+    }
+
+    ~ThreadSlot()
+    {
+        Registry &shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        accumulate(shared.retired, *metrics);
+        shared.live.erase(find(shared.live.begin(), shared.live.end(), metrics));
+        delete metrics;
+    }
+};
+
+ThreadMetrics &localMetrics()
+{
+    thread_local ThreadSlot slot;
+    return *slot.metrics;
+}
+
+struct CounterInfo
+{
+    const char *name;
+    const char *help;
+};
+
+const CounterInfo counterInfo[COUNTER_COUNT] = {
+    {"tictactoe_minimax_nodes_total", "Positions visited by minimax."},
+    {"tictactoe_solver_nodes_total", "Nodes expanded by the proof-number solver."},
+    {"tictactoe_mcts_playouts_total", "Playouts run by the Ultimate tree search."},
+    {"tictactoe_qubic_nodes_total", "Nodes searched by the Qubic alpha-beta search."},
+    {"tictactoe_ladder_nodes_total", "Nodes searched by the strength ladder."},
+    {"tictactoe_ai_moves_total", "Moves chosen by the computer."},
+    {"tictactoe_network_sent_bytes_total", "Bytes sent to the opponent."},
+    {"tictactoe_network_received_bytes_total", "Bytes received from the opponent."},
+    {"tictactoe_network_sent_messages_total", "Messages sent to the opponent."},
+    {"tictactoe_network_received_messages_total", "Messages received from the opponent."},
+    {"tictactoe_network_retransmits_total", "Datagrams sent again by the UDP transport after their timer expired."},
+    {"tictactoe_frames_total", "Frames drawn."},
+    {"tictactoe_prediction_rollbacks_total", "Optimistic multiplayer moves corrected by the opponent's echo."},
+    {"tictactoe_ai_service_requests_total", "Move requests made to the AI service."},
+    {"tictactoe_ai_service_cache_hits_total", "AI service requests answered from the result cache."},
+    {"tictactoe_ai_service_coalesced_total", "AI service requests that joined a search of the same or a symmetric position."},
+    {"tictactoe_ai_service_fallbacks_total", "AI service requests answered with a quick move because the deadline passed or the queue was full."},
+};
+
+const CounterInfo histogramInfo[HISTOGRAM_COUNT] = {
+    {"tictactoe_ai_think_seconds", "Time the computer spent choosing a move."},
+    {"tictactoe_network_round_trip_seconds", "Time from sending a game state to its acknowledgment."},
+    {"tictactoe_frame_seconds", "Time to draw and display one frame."},
+    {"tictactoe_startup_seconds", "Time from entering main until the font, glyphs and caches are ready."},
+    {"tictactoe_first_frame_seconds", "Time from entering main until the first frame is displayed."},
+    {"tictactoe_input_to_photon_seconds", "Time from a click on the board to the display of the frame showing it."},
+    {"tictactoe_ai_service_latency_seconds", "Time from a move request to the AI service until its answer."},
+    {"tictactoe_ai_service_queue_wait_seconds", "Time a position waited in the AI service queue before a worker took it."},
+};
+
+const CounterInfo gaugeInfo[GAUGE_COUNT] = {
+    {"tictactoe_ai_service_queue_depth", "Positions waiting for an AI service worker."},
+    {"tictactoe_ai_service_waiting_requests", "Move requests to the AI service not yet answered."},
+};
+
+atomic<int64_t> gauges[GAUGE_COUNT]; // set directly by the thread that changes the level
+
+class MetricsDumper
+{
+public:
+    ~MetricsDumper() { stop(); }
+
+    void start(const string &path, int intervalSeconds)
+    {
+        stop();
+        lock_guard<mutex> guard(lock);
+        this->path = path;
+        stopping = false;
+        worker = thread([this, intervalSeconds]() {
+            unique_lock<mutex> wait(lock);
+            while (!wakeup.wait_for(wait, chrono::seconds(intervalSeconds), [this]() { return stopping; }))
+            {
+                dumpMetrics(this->path);
+            }
+        });
+    }
+
+    void stop()
+    {
+        {
+            lock_guard<mutex> guard(lock);
+            if (!worker.joinable())
+                return;
+            stopping = true;
+        }
+        wakeup.notify_all();
+        worker.join();
+        dumpMetrics(path); // final values on shutdown
+    }
+
+private:
+    mutex lock;
+    condition_variable wakeup;
+    thread worker;
+    string path;
+    bool stopping = false;
+};
+}
+
+/**
+ * @brief Adds to a counter for the calling thread.
+ *
+ * @param counter The counter to increase.
+ * @param amount How much to add.
+ */
+void countMetric(COUNTER counter, uint64_t amount)
+{
+    bump(localMetrics().counters[counter], amount);
+}
+
+/**
+ * @brief Records one latency sample for the calling thread.
+ *
+ * @param histogram The histogram to record into.
+ * @param microseconds The measured latency.
+ */
+void recordLatency(HISTOGRAM histogram, uint64_t microseconds)
+{
+    ThreadHistogram &target = localMetrics().histograms[histogram];
+    bump(target.buckets[histogramBucket(microseconds)], 1);
+    bump(target.count, 1);
+    bump(target.sum, microseconds);
+    if (microseconds > target.max.load(memory_order_relaxed))
+        target.max.store(microseconds, memory_order_relaxed);
+}
+
+/**
+ * @brief Sets the current level of a gauge.
+ */
+void setGauge(GAUGE gauge, int64_t value)
+{
+    gauges[gauge].store(value, memory_order_relaxed);
+}
+
+/**
+ * @brief Returns a monotonic timestamp in microseconds, for latency measurements.
+ */
+uint64_t metricsClockMicros()
+{
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Maps a value to its histogram bucket.
+ *
+ * Values below 8 get a bucket each; above that every power of two is split into 8 equal buckets.
+ */
+int histogramBucket(uint64_t microseconds)
+{
+    if (microseconds < 8)
+        return static_cast<int>(microseconds);
+    int exponent = 63 - __builtin_clzll(microseconds);
+    int mantissa = static_cast<int>((microseconds >> (exponent - 3)) & 7);
+    return (exponent - 2) * 8 + mantissa;
+}
+
+/**
+ * @brief Returns the largest value that falls into a bucket.
+ */
+uint64_t histogramBucketUpperBound(int bucket)
+{
+    if (bucket < 8)
+        return bucket;
+    int exponent = bucket / 8 + 2;
+    uint64_t lower = static_cast<uint64_t>(8 + bucket % 8) << (exponent - 3);
+    return lower + ((1ULL << (exponent - 3)) - 1);
+}
+
+/**
+ * @brief Estimates a percentile from the histogram.
+ *
+ * @param fraction The percentile as a fraction (0.99 for p99).
+ * @return The upper bound of the bucket holding the percentile, capped at the largest sample.
+ */
+uint64_t HistogramSnapshot::percentile(double fraction) const
+{
+    if (count == 0)
+        return 0;
+    uint64_t rank = static_cast<uint64_t>(fraction * count + 0.5);
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (int b = 0; b < HISTOGRAM_BUCKETS; ++b)
+    {
+        seen += buckets[b];
+        if (seen >= rank)
+            return std::min(histogramBucketUpperBound(b), max);
+    }
+    return max;
+}
+
+/**
+ * @brief Sums the metrics of every thread, including threads that have exited.
+ */
+MetricsSnapshot collectMetrics()
+{
+    MetricsSnapshot snapshot;
+    Registry &shared = registry();
+    lock_guard<mutex> guard(shared.lock);
+    snapshot = shared.retired;
+    for (const ThreadMetrics *metrics : shared.live)
+        accumulate(snapshot, *metrics);
+    for (int g = 0; g < GAUGE_COUNT; ++g)
+        snapshot.gauges[g] = gauges[g].load(memory_order_relaxed);
+    return snapshot;
+}
+
+/**
+ * @brief Formats a snapshot in the Prometheus text exposition format.
+ *
+ * Histograms list only non-empty buckets (cumulative, as Prometheus expects) with bounds in seconds.
+ */
+string formatPrometheus(const MetricsSnapshot &snapshot)
+{
+    ostringstream out;
+    out << setprecision(12);
+    for (int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        out << "# HELP " << counterInfo[i].name << " " << counterInfo[i].help << "\n";
+        out << "# TYPE " << counterInfo[i].name << " counter\n";
+        out << counterInfo[i].name << " " << snapshot.counters[i] << "\n";
+    }
+    for (int g = 0; g < GAUGE_COUNT; ++g)
+    {
+        out << "# HELP " << gaugeInfo[g].name << " " << gaugeInfo[g].help << "\n";
+        out << "# TYPE " << gaugeInfo[g].name << " gauge\n";
+        out << gaugeInfo[g].name << " " << snapshot.gauges[g] << "\n";
+    }
+    for (int h = 0; h < HISTOGRAM_COUNT; ++h)
+    {
+        const HistogramSnapshot &histogram = snapshot.histograms[h];
+        const char *name = histogramInfo[h].name;
+        out << "# HELP " << name << " " << histogramInfo[h].help << "\n";
+        out << "# TYPE " << name << " histogram\n";
+        uint64_t cumulative = 0;
+        for (int b = 0; b < HISTOGRAM_BUCKETS; ++b)
+        {
+            if (histogram.buckets[b] == 0)
+                continue;
+            cumulative += histogram.buckets[b];
+            out << name << "_bucket{le=\"" << histogramBucketUpperBound(b) / 1e6 << "\"} " << cumulative << "\n";
+        }
+        out << name << "_bucket{le=\"+Inf\"} " << histogram.count << "\n";
+        out << name << "_sum " << histogram.sum / 1e6 << "\n";
+        out << name << "_count " << histogram.count << "\n";
+    }
+    return out.str();
+}
+
+/**
+ * @brief Writes the current metrics to a file in Prometheus text format.
+ *
+ * The file is written to a temporary path and renamed, so a scraper never sees a partial file.
+ *
+ * @param path The output file path.
+ * @return True if the file was written.
+ */
+bool dumpMetrics(const string &path)
+{
+    string tempPath = path + ".tmp";
+    {
+        ofstream out(tempPath, ios::trunc);
+        out << formatPrometheus(collectMetrics());
+        if (!out)
+        {
+            cerr << "Failed to write metrics file!" << endl;
+            return false;
+        }
+    }
+    if (rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        cerr << "Failed to replace metrics file!" << endl;
+        remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+namespace
+{
+MetricsDumper &dumper()
+{
+    registry(); // constructed first so it outlives the dumper's final dump
+    static MetricsDumper instance;
+    return instance;
+}
+}
+
+/**
+ * @brief Starts writing the metrics file every `intervalSeconds` seconds from a background thread.
+ *
+ * The file is also written one last time when the dump is stopped or the program exits.
+ */
+void startMetricsDump(const string &path, int intervalSeconds)
+{
+    dumper().start(path, intervalSeconds);
+}
+
+/**
+ * @brief Stops the periodic dump and writes the final values.
+ */
+void stopMetricsDump()
+{
+    dumper().stop();
+}
+
+ScopedLatency::ScopedLatency(HISTOGRAM histogram) : histogram(histogram), start(metricsClockMicros())
+{
+}
+
+ScopedLatency::~ScopedLatency()
+{
+    recordLatency(histogram, metricsClockMicros() - start);
+}
@@ -0,0 +1,461 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This file implements the exact m,n,k solver. It is an alpha-beta search over the three values
+win, draw and loss, so most positions are decided by the first good move. A player who can
+complete a line wins at once, one facing two open threats loses, one facing a single threat must
+block it, and a player with no open line left can at best draw, which bounds the search window.
+Moves are tried in order of the open lines they extend or block, and solved bounds are kept in a
+transposition table that survives from one position to the next.
+*/
+
+#include "mnk.hpp"
+#include <algorithm>
+#include <chrono>
+#include <set>
+
+namespace
+{
+const int MAX_MNK_CELLS = 256; // largest board, so move lists fit on the stack
+
+/**
+ * @brief Returns the hash key contribution of a mark on a cell (splitmix64 of the cell and side).
+ */
+uint64_t zobrist(int cell, int side)
+{
+    uint64_t z = static_cast<uint64_t>(cell * 2 + side + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+const uint64_t SIDE_KEY = 0x2545F4914F6CDD1DULL; // toggled when the player to move changes
+
+/**
+ * @brief Finds the empty cell of a line holding length - 1 marks of one player and none of the other.
+ */
+int missingCell(const MnkBoard &board, int line)
+{
+    const int *lineCells = &board.lines->cells[line * board.length];
+    for (int i = 0; i < board.length; ++i)
+    {
+        if (board.cells[lineCells[i]] == 0)
+            return lineCells[i];
+    }
+    return -1;
+}
+
+class MnkSearch
+{
+public:
+    MnkSearch(MnkBoard &board, MnkTable &table) : board(board), table(table) {}
+
+    uint64_t nodes = 0;
+
+    /**
+     * @brief Returns the value of a position that is not over for the player to move.
+     */
+    int search(int alpha, int beta)
+    {
+        nodes++;
+        int me = board.toMove, opponent = 1 - me;
+        const vector<uint8_t> &mine = board.lineCount[me];
+        const vector<uint8_t> &theirs = board.lineCount[opponent];
+
+        // Completing a line wins; two open threats of the opponent cannot both be blocked
+        int threat = -1;
+        bool twoThreats = false;
+        for (int line = 0; line < board.lines->count; ++line)
+        {
+            if (mine[line] == board.length - 1 && theirs[line] == 0)
+                return 1;
+            if (theirs[line] == board.length - 1 && mine[line] == 0)
+            {
+                int cell = missingCell(board, line);
+                twoThreats |= threat >= 0 && cell != threat;
+                threat = cell;
+            }
+        }
+        if (twoThreats)
+            return -1;
+
+        // A player without an open line cannot win
+        if (board.openLines[me] == 0)
+            beta = min(beta, 0);
+        if (board.openLines[opponent] == 0)
+            alpha = max(alpha, 0);
+        if (alpha >= beta)
+            return alpha;
+
+        int lower, upper;
+        if (table.lookup(board.hash, lower, upper))
+        {
+            if (lower >= beta || lower == upper)
+                return lower;
+            if (upper <= alpha)
+                return upper;
+            alpha = max(alpha, lower);
+            beta = min(beta, upper);
+        }
+
+        int moves[MAX_MNK_CELLS];
+        int count = threat >= 0 ? 1 : orderedMoves(moves);
+        if (threat >= 0)
+            moves[0] = threat; // forced block
+
+        uint64_t nodesBefore = nodes;
+        int best = -1;
+        for (int i = 0; i < count && best < beta; ++i)
+        {
+            board.play(moves[i]);
+            int value = board.winner >= 0 ? 1 : board.empties == 0 ? 0 : -search(-beta, -max(alpha, best));
+            board.undo(moves[i]);
+            best = max(best, value);
+        }
+
+        // A result outside the window only bounds the value from one side
+        table.store(board.hash, best > alpha ? best : -1, best < beta ? best : 1, nodes - nodesBefore);
+        return best;
+    }
+
+private:
+    MnkBoard &board;
+    MnkTable &table;
+
+    /**
+     * @brief Lists the empty cells, those on the most promising open lines (of either player) first.
+     */
+    int orderedMoves(int *moves) const
+    {
+        int me = board.toMove;
+        int scores[MAX_MNK_CELLS];
+        int count = 0;
+        for (int cell = 0; cell < static_cast<int>(board.cells.size()); ++cell)
+        {
+            if (board.cells[cell] != 0)
+                continue;
+            int score = 0;
+            for (int line : board.lines->linesByCell[cell])
+            {
+                int own = board.lineCount[me][line], other = board.lineCount[1 - me][line];
+                if (other == 0)
+                    score += 2 << (2 * own); // extends an open line, slightly ahead of blocking one
+                if (own == 0)
+                    score += 1 << (2 * other);
+            }
+            // insertion sort, highest score first
+            int i = count++;
+            for (; i > 0 && scores[i - 1] < score; --i)
+            {
+                scores[i] = scores[i - 1];
+                moves[i] = moves[i - 1];
+            }
+            scores[i] = score;
+            moves[i] = cell;
+        }
+        return count;
+    }
+};
+
+/**
+ * @brief Lists the cell permutations that map the board onto itself (four, or eight if it is square).
+ */
+vector<vector<int>> symmetries(int rows, int cols)
+{
+    vector<vector<int>> maps;
+    int transforms = rows == cols ? 8 : 4;
+    for (int t = 0; t < transforms; ++t)
+    {
+        vector<int> permutation(rows * cols);
+        for (int row = 0; row < rows; ++row)
+        {
+            for (int col = 0; col < cols; ++col)
+            {
+                int r = row, c = col;
+                if (t & 4)
+                    swap(r, c); // transpose (square boards only)
+                if (t & 1)
+                    r = rows - 1 - r;
+                if (t & 2)
+                    c = cols - 1 - c;
+                permutation[row * cols + col] = r * cols + c;
+            }
+        }
+        maps.push_back(permutation);
+    }
+    return maps;
+}
+
+void collectPartitions(MnkBoard &board, int plies, set<string> &seen, vector<string> &partitions)
+{
+    string key = board.canonicalText();
+    if (!seen.insert(key).second)
+        return; // a symmetric position was reached before
+    if (plies == 0)
+    {
+        partitions.push_back(key);
+        return;
+    }
+    for (int cell = 0; cell < static_cast<int>(board.cells.size()); ++cell)
+    {
+        if (board.cells[cell] != 0)
+            continue;
+        board.play(cell);
+        if (!board.over())
+            collectPartitions(board, plies - 1, seen, partitions);
+        board.undo(cell);
+    }
+}
+
+int combineValue(MnkBoard &board, int plies, const map<string, int> &values, vector<pair<int, int>> *moveValues)
+{
+    if (board.winner >= 0)
+        return -1; // the previous move completed a line
+    if (board.empties == 0)
+        return 0;
+    if (plies == 0)
+        return values.at(board.canonicalText());
+
+    int best = -1;
+    for (int cell = 0; cell < static_cast<int>(board.cells.size()); ++cell)
+    {
+        if (board.cells[cell] != 0)
+            continue;
+        board.play(cell);
+        int value = -combineValue(board, plies - 1, values, nullptr);
+        board.undo(cell);
+        if (moveValues)
+            moveValues->push_back({cell, value});
+        best = max(best, value);
+    }
+    return best;
+}
+}
+
+/**
+ * @brief Constructs an empty m,n,k board.
+ *
+ * @param rows Board rows (m).
+ * @param cols Board columns (n); rows * cols may be at most 256.
+ * @param length Marks in a row needed to win (k).
+ */
+MnkBoard::MnkBoard(int rows, int cols, int length)
+    : lines(&getLineTable(rows, cols, length)), rows(rows), cols(cols), length(length)
+{
+    cells.assign(rows * cols, 0);
+    lineCount[0].assign(lines->count, 0);
+    lineCount[1].assign(lines->count, 0);
+    openLines[0] = openLines[1] = lines->count;
+    empties = rows * cols;
+    hash = zobrist(MAX_MNK_CELLS + (rows << 16 | cols << 8 | length), 0); // boards of different shapes can share a table
+}
+
+/**
+ * @brief Replaces the position with one written as x, o and . characters ('/' between rows is ignored).
+ *
+ * @return False if the text does not fit the board or X and O have not taken turns.
+ */
+bool MnkBoard::setCells(const string &text)
+{
+    string marks;
+    for (char c : text)
+    {
+        if (c == 'x' || c == 'X' || c == 'o' || c == 'O' || c == '.')
+            marks += static_cast<char>(tolower(c));
+        else if (c != '/')
+            return false;
+    }
+    int xCount = static_cast<int>(count(marks.begin(), marks.end(), 'x'));
+    int oCount = static_cast<int>(count(marks.begin(), marks.end(), 'o'));
+    if (static_cast<int>(marks.size()) != rows * cols || (xCount != oCount && xCount != oCount + 1))
+        return false;
+
+    *this = MnkBoard(rows, cols, length);
+    // Place the marks in turn order, so the player to move and the hash come out right
+    vector<int> xCells, oCells;
+    for (int cell = 0; cell < rows * cols; ++cell)
+    {
+        if (marks[cell] == 'x')
+            xCells.push_back(cell);
+        else if (marks[cell] == 'o')
+            oCells.push_back(cell);
+    }
+    for (int i = 0; i < xCount; ++i)
+    {
+        play(xCells[i]);
+        if (i < oCount)
+            play(oCells[i]);
+    }
+    return true;
+}
+
+string MnkBoard::text() const
+{
+    string out;
+    for (uint8_t cell : cells)
+        out += cell == 1 ? 'x' : cell == 2 ? 'o' : '.';
+    return out;
+}
+
+/**
+ * @brief Returns the smallest text of the position over the board's symmetries, so symmetric
+ *        positions share one name.
+ */
+string MnkBoard::canonicalText() const
+{
+    static thread_local map<pair<int, int>, vector<vector<int>>> cache;
+    auto it = cache.find({rows, cols});
+    if (it == cache.end())
+        it = cache.emplace(make_pair(rows, cols), symmetries(rows, cols)).first;
+
+    string plain = text(), best;
+    for (const vector<int> &permutation : it->second)
+    {
+        string mapped(plain.size(), '.');
+        for (size_t cell = 0; cell < plain.size(); ++cell)
+            mapped[permutation[cell]] = plain[cell];
+        if (best.empty() || mapped < best)
+            best = mapped;
+    }
+    return best;
+}
+
+/**
+ * @brief Places a mark for the player to move. The cell must be empty.
+ */
+void MnkBoard::play(int cell)
+{
+    int player = toMove;
+    cells[cell] = static_cast<uint8_t>(player + 1);
+    for (int line : lines->linesByCell[cell])
+    {
+        if (lineCount[player][line]++ == 0 && lineCount[1 - player][line] == 0)
+            openLines[1 - player]--; // the opponent can no longer complete this line
+        if (lineCount[player][line] == length)
+            winner = player;
+    }
+    empties--;
+    hash ^= zobrist(cell, player) ^ SIDE_KEY;
+    toMove = 1 - player;
+}
+
+/**
+ * @brief Removes the mark placed by the last play().
+ */
+void MnkBoard::undo(int cell)
+{
+    int player = 1 - toMove;
+    for (int line : lines->linesByCell[cell])
+    {
+        if (--lineCount[player][line] == 0 && lineCount[1 - player][line] == 0)
+            openLines[1 - player]++;
+    }
+    cells[cell] = 0;
+    empties++;
+    winner = -1; // play() is never called on a finished position
+    hash ^= zobrist(cell, player) ^ SIDE_KEY;
+    toMove = player;
+}
+
+/**
+ * @brief Allocates a table of at most the given size.
+ */
+MnkTable::MnkTable(size_t megabytes)
+{
+    size_t slots = 2;
+    while (slots * 2 * sizeof(Entry) <= megabytes * 1024 * 1024)
+        slots *= 2;
+    entries.assign(slots, Entry{0, -1, 1, 0});
+    bucketMask = slots / 2 - 1;
+}
+
+bool MnkTable::lookup(uint64_t key, int &lower, int &upper) const
+{
+    const Entry *bucket = &entries[(key & bucketMask) * 2];
+    for (int i = 0; i < 2; ++i)
+    {
+        if (bucket[i].key == key)
+        {
+            lower = bucket[i].lower;
+            upper = bucket[i].upper;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Stores the bounds of a position; when both slots of its bucket are taken, the one that
+ *        cost less work to compute is replaced.
+ */
+void MnkTable::store(uint64_t key, int lower, int upper, uint64_t work)
+{
+    Entry *bucket = &entries[(key & bucketMask) * 2];
+    Entry *slot = bucket[0].work <= bucket[1].work ? &bucket[0] : &bucket[1];
+    for (int i = 0; i < 2; ++i)
+    {
+        if (bucket[i].key == key)
+        {
+            slot = &bucket[i];
+            lower = max(lower, static_cast<int>(slot->lower)); // keep what was proven before
+            upper = min(upper, static_cast<int>(slot->upper));
+            work += slot->work;
+        }
+    }
+    *slot = Entry{key, static_cast<int8_t>(lower), static_cast<int8_t>(upper), work};
+}
+
+/**
+ * @brief Proves the value of a position for the player to move.
+ *
+ * @param board The position.
+ * @param table Bounds proven by earlier searches; the search adds to it.
+ */
+MnkSolveResult solveMnk(MnkBoard board, MnkTable &table)
+{
+    MnkSolveResult result;
+    auto start = chrono::steady_clock::now();
+    if (board.winner >= 0)
+        result.value = -1; // the previous move completed a line
+    else if (board.empties > 0)
+    {
+        MnkSearch search(board, table);
+        result.value = search.search(-1, 1);
+        result.nodes = search.nodes;
+    }
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+/**
+ * @brief Splits a position into the symmetry-distinct positions `plies` moves later.
+ *
+ * Lines of play that end the game before then are left out; combinePartitions() scores them itself.
+ *
+ * @return The canonical texts of the partitions.
+ */
+vector<string> openingPartitions(const MnkBoard &root, int plies)
+{
+    MnkBoard board = root;
+    set<string> seen;
+    vector<string> partitions;
+    if (!board.over())
+        collectPartitions(board, plies, seen, partitions);
+    return partitions;
+}
+
+/**
+ * @brief Computes the value of a position from the values of its partitions.
+ *
+ * @param values Value of each partition for its player to move, by canonical text. Every
+ *        partition returned by openingPartitions() must be present.
+ * @param moveValues If not null, receives the value of each first move (cell, value for the
+ *        player to move at the root).
+ * @return The value for the player to move at the root.
+ */
+int combinePartitions(MnkBoard root, int plies, const map<string, int> &values, vector<pair<int, int>> *moveValues)
+{
+    return combineValue(root, plies, values, moveValues);
+}
@@ -1,19 +1,190 @@
 /*
 Author: Arina Shah
 Class: ECE4122 (A)
-Last Date Modified: 12/3/2024
+Last Date Modified: 10/19/2026
 Description:
 This file manages the networking functionality for multiplayer mode. It includes functions
 to send and receive game states over a socket and set up the server and client connections.
+After the handshake the two sides agree on a transport: shared memory when both players run on
+the same machine, otherwise UDP with its own reliability layer if enabled, and TCP as the fallback. Game messages carry sequence numbers and the server hands out a
+session token, so if the connection drops the client reconnects with backoff, both sides report
+the last message they saw, and only the missed messages are sent again. Moves are shown before
+they are sent: the server checks each move of the client and echoes its own state back, and the
+client reconciles the move it predicted with that echo.
 */
 
 #include "network.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+#include <chrono>
+#include <deque>
+#include <random>
+#include <sstream>
+#include <thread>
 
 using namespace std;
 using namespace sf;
 
 TcpSocket socket;
 
+namespace
+{
+TcpListener listener; // kept open by the server so a dropped client can reconnect
+bool isServer = false;
+string sessionToken; // identifies this game to a reconnecting client
+uint32_t sendSequence = 0; // sequence number of the last game message sent
+uint32_t receiveSequence = 0; // sequence number of the last game message received
+deque<pair<uint32_t, string>> sentHistory; // recent outgoing messages, replayed after a resume
+deque<pair<uint32_t, uint64_t>> unacknowledged; // posted messages still waiting for their acknowledgment, with send times
+
+/**
+ * @brief Builds the next game message and keeps it for replay after a resume.
+ */
+string nextGameMessage(const Game &game, uint32_t &sequence)
+{
+    sequence = ++sendSequence;
+    string message = "G " + to_string(sequence) + " " + game.serialize();
+    sentHistory.emplace_back(sequence, message);
+    if (sentHistory.size() > RESUME_HISTORY)
+    {
+        sentHistory.pop_front();
+    }
+    return message;
+}
+
+/**
+ * @brief Records the round trip of a posted message when its acknowledgment arrives.
+ */
+void acknowledge(uint32_t sequence)
+{
+    while (!unacknowledged.empty() && unacknowledged.front().first <= sequence)
+    {
+        if (unacknowledged.front().first == sequence)
+            recordLatency(NETWORK_ROUND_TRIP, metricsClockMicros() - unacknowledged.front().second);
+        unacknowledged.pop_front();
+    }
+}
+
+/**
+ * @brief Replays every sent message the peer has not seen, or just the newest one if the
+ *        missed messages are no longer in the history.
+ */
+void replayMissed(uint32_t peerLastSeen)
+{
+    if (sentHistory.empty() || sentHistory.back().first <= peerLastSeen)
+        return;
+    if (sentHistory.front().first > peerLastSeen + 1)
+    {
+        transport->sendMessage(sentHistory.back().second); // game messages are full snapshots
+        return;
+    }
+    for (const pair<uint32_t, string> &entry : sentHistory)
+    {
+        if (entry.first > peerLastSeen)
+            transport->sendMessage(entry.second);
+    }
+}
+
+/**
+ * @brief Waits for the client to reconnect with this session's token.
+ *
+ * @return The last sequence number the client received.
+ * @throws Exits the program if the client does not come back within RESUME_TIMEOUT_SECONDS.
+ */
+uint32_t acceptResume()
+{
+    SocketSelector selector;
+    selector.add(listener);
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(RESUME_TIMEOUT_SECONDS);
+    while (true)
+    {
+        auto remaining = chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now());
+        if (remaining.count() <= 0 || !selector.wait(milliseconds(static_cast<Int32>(remaining.count()))))
+        {
+            cerr << "Opponent did not reconnect, giving up" << endl;
+            exit(1);
+        }
+        if (listener.accept(socket) != Socket::Done)
+            continue;
+
+        char buffer[128] = {};
+        size_t received;
+        string command, token;
+        uint32_t peerLastSeen = 0;
+        if (socket.receive(buffer, sizeof(buffer) - 1, received) == Socket::Done)
+        {
+            istringstream(string(buffer)) >> command >> token >> peerLastSeen;
+        }
+        if (command != "resume" || token != sessionToken)
+        {
+            socket.disconnect(); // not our client; keep waiting
+            continue;
+        }
+        string reply = "resume-ok " + to_string(receiveSequence);
+        if (socket.send(reply.c_str(), reply.size() + 1) != Socket::Done)
+        {
+            socket.disconnect();
+            continue;
+        }
+        return peerLastSeen;
+    }
+}
+
+/**
+ * @brief Reconnects to the server, retrying with exponential backoff.
+ *
+ * @return The last sequence number the server received.
+ * @throws Exits the program if the server cannot be reached within RESUME_TIMEOUT_SECONDS.
+ */
+uint32_t requestResume()
+{
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(RESUME_TIMEOUT_SECONDS);
+    chrono::milliseconds delay(100);
+    while (chrono::steady_clock::now() < deadline)
+    {
+        socket.disconnect();
+        if (socket.connect(SERVER_IP, PORT, seconds(1)) == Socket::Done)
+        {
+            string request = "resume " + sessionToken + " " + to_string(receiveSequence);
+            char buffer[128] = {};
+            size_t received;
+            if (socket.send(request.c_str(), request.size() + 1) == Socket::Done &&
+                socket.receive(buffer, sizeof(buffer) - 1, received) == Socket::Done)
+            {
+                string command;
+                uint32_t peerLastSeen = 0;
+                istringstream(string(buffer)) >> command >> peerLastSeen;
+                if (command == "resume-ok")
+                    return peerLastSeen;
+            }
+        }
+        this_thread::sleep_for(delay);
+        delay = min(delay * 2, chrono::milliseconds(2000));
+    }
+    cerr << "Could not reconnect to server, giving up" << endl;
+    exit(1);
+}
+
+/**
+ * @brief Re-establishes a dropped connection and resends whatever the peer missed.
+ *
+ * The resumed session always runs over TCP, even if it started on shared memory or UDP.
+ *
+ * @return The last sequence number the peer had received before the drop.
+ */
+uint32_t resumeSession()
+{
+    TRACE_SPAN("resumeSession");
+    cout << "Connection lost, resuming session..." << endl;
+    transport.reset();
+    uint32_t peerLastSeen = isServer ? acceptResume() : requestResume();
+    transport.reset(new TcpTransport(socket));
+    replayMissed(peerLastSeen);
+    cout << "Session resumed" << endl;
+    return peerLastSeen;
+}
+}
+
 /**
  * @brief Sets up the server for a multiplayer game by creating a listener, accepting a client connection, 
  *        and performing a handshake to ensure the connection is ready.
@@ -22,10 +193,10 @@ TcpSocket socket;
  */
 void setupServer()
 {
-    TcpListener listener;
-    if (listener.listen(54000) != Socket::Done)
+    isServer = true;
+    if (listener.listen(PORT) != Socket::Done)
     {
-        cerr << "Failed to bind listener socket to port 54000" << endl;
+        cerr << "Failed to bind listener socket to port " << PORT << endl;
         exit(1);
     }
 
@@ -38,8 +209,12 @@ void setupServer()
 
     cout << "Client connected! Sending handshake..." << endl;
 
-    // Handshake: Send "ready" to the client
-    string readyMessage = "ready";
+    // Handshake: Send "ready" and the session token to the client
+    mt19937_64 generator(random_device{}());
+    ostringstream token;
+    token << hex << generator();
+    sessionToken = token.str();
+    string readyMessage = "ready " + sessionToken;
     if (socket.send(readyMessage.c_str(), readyMessage.size() + 1) != Socket::Done)
     {
         cerr << "Failed to send handshake message to client!" << endl;
@@ -61,7 +236,43 @@ void setupServer()
         exit(1);
     }
 
-    cout << "Handshake complete. Ready to start the game!" << endl;
+    // Offer a shared-memory segment if the client is on this machine, then UDP, then plain TCP
+    transport.reset(new TcpTransport(socket));
+    unique_ptr<SharedMemoryTransport> sharedMemory;
+    unique_ptr<UdpTransport> udp;
+    if (SHARED_MEMORY_TRANSPORT && SharedMemoryTransport::isSupported() &&
+        socket.getRemoteAddress() == IpAddress::LocalHost)
+    {
+        sharedMemory = SharedMemoryTransport::create();
+    }
+    if (!sharedMemory && UDP_TRANSPORT)
+    {
+        udp = UdpTransport::bind();
+    }
+    string offer = sharedMemory ? "shm " + sharedMemory->getSegmentName()
+                   : udp        ? "udp " + to_string(udp->getLocalPort())
+                                : "tcp";
+    if (socket.send(offer.c_str(), offer.size() + 1) != Socket::Done ||
+        socket.receive(buffer, sizeof(buffer), received) != Socket::Done)
+    {
+        cerr << "Failed to negotiate a transport with the client!" << endl;
+        exit(1);
+    }
+    string reply;
+    unsigned short clientPort = 0;
+    istringstream(string(buffer)) >> reply >> clientPort;
+    if (sharedMemory && reply == "shm-ok")
+    {
+        sharedMemory->unlink(); // both sides have it mapped, so the name is no longer needed
+        transport = move(sharedMemory);
+    }
+    else if (udp && reply == "udp-ok")
+    {
+        udp->connect(socket.getRemoteAddress(), clientPort);
+        transport = move(udp);
+    }
+
+    cout << "Handshake complete (" << transport->name() << " transport). Ready to start the game!" << endl;
 }
 
 /**
@@ -72,7 +283,7 @@ void setupServer()
  */
 void setupClient()
 {
-    if (socket.connect("127.0.0.1", 54000) != Socket::Done)
+    if (socket.connect(SERVER_IP, PORT) != Socket::Done)
     {
         cerr << "Failed to connect to server!" << endl;
         exit(1);
@@ -89,7 +300,9 @@ void setupClient()
         exit(1);
     }
 
-    if (string(buffer) != "ready")
+    string command;
+    istringstream(string(buffer)) >> command >> sessionToken;
+    if (command != "ready")
     {
         cerr << "Invalid handshake message from server!" << endl;
         exit(1);
@@ -103,11 +316,45 @@ void setupClient()
         exit(1);
     }
 
-    cout << "Handshake complete. Ready to start the game!" << endl;
+    // Accept the server's shared-memory or UDP offer if it can be set up, otherwise stay on TCP
+    if (socket.receive(buffer, sizeof(buffer), received) != Socket::Done)
+    {
+        cerr << "Failed to receive transport offer from server!" << endl;
+        exit(1);
+    }
+    transport.reset(new TcpTransport(socket));
+    string offer(buffer);
+    unique_ptr<SharedMemoryTransport> sharedMemory;
+    unique_ptr<UdpTransport> udp;
+    if (offer.compare(0, 4, "shm ") == 0)
+    {
+        sharedMemory = SharedMemoryTransport::attach(offer.substr(4));
+    }
+    else if (offer.compare(0, 4, "udp ") == 0)
+    {
+        udp = UdpTransport::bind();
+    }
+    string reply = sharedMemory ? "shm-ok" : udp ? "udp-ok " + to_string(udp->getLocalPort()) : "tcp";
+    if (socket.send(reply.c_str(), reply.size() + 1) != Socket::Done)
+    {
+        cerr << "Failed to answer transport offer from server!" << endl;
+        exit(1);
+    }
+    if (sharedMemory)
+    {
+        transport = move(sharedMemory);
+    }
+    else if (udp)
+    {
+        udp->connect(socket.getRemoteAddress(), static_cast<unsigned short>(stoi(offer.substr(4))));
+        transport = move(udp);
+    }
+
+    cout << "Handshake complete (" << transport->name() << " transport). Ready to start the game!" << endl;
 }
 
 /**
- * @brief Sends the player's move (row and column) to the opponent over the socket.
+ * @brief Sends the player's move (row and column) to the opponent over the transport.
  * 
  * @param row The row index of the player's move (0-based).
  * @param col The column index of the player's move (0-based).
@@ -117,14 +364,14 @@ void setupClient()
 void sendMove(int row, int col)
 {
     string move = to_string(row) + " " + to_string(col);
-    if (socket.send(move.c_str(), move.size() + 1) != Socket::Done)
+    if (!transport->sendMessage(move))
     {
         cerr << "Error sending move!" << endl;
     }
 }
 
 /**
- * @brief Receives the opponent's move (row and column) from the socket.
+ * @brief Receives the opponent's move (row and column) from the transport.
  * 
  * @return A pair of integers representing the row and column of the opponent's move.
  * 
@@ -132,83 +379,205 @@ void sendMove(int row, int col)
  */
 pair<int, int> receiveMove()
 {
-    char buffer[128];
-    size_t received;
-    if (socket.receive(buffer, sizeof(buffer), received) != Socket::Done)
+    string move;
+    if (!transport->receiveMessage(move))
     {
         cerr << "Error receiving move!" << endl;
     }
-    int row, col;
-    sscanf(buffer, "%d %d", &row, &col);
+    int row = -1, col = -1;
+    sscanf(move.c_str(), "%d %d", &row, &col);
     return {row, col};
 }
 
 /**
- * @brief Sends the serialized game state to the opponent over the socket and waits for acknowledgment
+ * @brief Sends the serialized game state to the opponent over the transport and waits for acknowledgment
  *        to ensure successful delivery.
  * 
  * @param game The current game state to be serialized and sent.
  * 
- * @throws Outputs an error message if the game state fails to send or acknowledgment fails to receive.
+ * If the connection drops before the acknowledgment arrives, the session is resumed and the message
+ * is resent only if the opponent never received it.
  */
 void sendGame(Game game)
 {
-    string gameData = game.serialize();
-    bool ackReceived = false;
+    TRACE_SPAN("sendGame");
+    uint32_t sequence;
+    string message = nextGameMessage(game, sequence);
 
-    while (!ackReceived)
+    string expectedAck = "ACK " + to_string(sequence);
+    uint64_t sentAt = metricsClockMicros();
+    bool sent = transport->sendMessage(message);
+    while (true)
     {
-        // Send the serialized game state
-        if (socket.send(gameData.c_str(), gameData.size() + 1) != Socket::Done)
+        // Wait for acknowledgment; older acknowledgments can show up after a resume
+        string reply;
+        if (sent && transport->receiveMessage(reply))
         {
-            cerr << "Error sending game!" << endl;
+            if (reply == expectedAck)
+            {
+                recordLatency(NETWORK_ROUND_TRIP, metricsClockMicros() - sentAt);
+                return; // Acknowledgment received
+            }
             continue;
         }
 
-        // Wait for acknowledgment
-        char buffer[128];
-        size_t received;
-        if (socket.receive(buffer, sizeof(buffer), received) == Socket::Done)
+        cerr << "Error sending game!" << endl;
+        if (resumeSession() >= sequence) // otherwise the message was resent during the resume
         {
-            if (string(buffer) == "ACK")
-            {
-                ackReceived = true; // Acknowledgment received
-            }
+            return;
         }
+        sent = true;
+    }
+}
+
+/**
+ * @brief Sends the serialized game state to the opponent without waiting for the acknowledgment.
+ *
+ * @param game The current game state to be serialized and sent.
+ *
+ * The acknowledgment is picked up by a later receiveGame(), which records the round trip. If the
+ * send fails the session is resumed, which resends the message if the opponent never received it.
+ */
+void postGame(const Game &game)
+{
+    TRACE_SPAN("postGame");
+    uint32_t sequence;
+    string message = nextGameMessage(game, sequence);
+    unacknowledged.emplace_back(sequence, metricsClockMicros());
+    if (!transport->sendMessage(message))
+    {
+        cerr << "Error sending game!" << endl;
+        resumeSession();
     }
 }
 
 /**
- * @brief Receives the serialized game state from the opponent over the socket, deserializes it into a
+ * @brief Receives the serialized game state from the opponent over the transport, deserializes it into a
  *        `Game` object, and sends an acknowledgment back to confirm successful receipt.
  * 
  * @return The deserialized `Game` object representing the received game state.
  * 
- * @throws Outputs an error message if the game state fails to receive or acknowledgment fails to send.
+ * Messages already received before a resume are acknowledged again but otherwise ignored.
+ * Acknowledgments of posted messages that arrive first are consumed along the way.
  */
 Game receiveGame()
 {
-    char buffer[1024];
-    size_t received;
+    TRACE_SPAN("receiveGame");
     Game receivedGame;
-    bool gameReceived = false;
 
-    while (!gameReceived)
+    while (true)
     {
-        // Receive the serialized game state
-        if (socket.receive(buffer, sizeof(buffer), received) == Socket::Done)
+        string message;
+        if (!transport->receiveMessage(message))
+        {
+            cerr << "Error receiving game!" << endl;
+            resumeSession();
+            continue;
+        }
+
+        // Messages are "G <sequence> <serialized game>"
+        istringstream header(message);
+        string type;
+        uint32_t sequence = 0;
+        if (!(header >> type >> sequence))
         {
-            receivedGame.deserialize(string(buffer)); // Deserialize game state
-            gameReceived = true;
+            continue;
+        }
+        if (type == "ACK")
+        {
+            acknowledge(sequence);
+            continue;
+        }
+        if (type != "G")
+        {
+            continue;
+        }
 
-            // Send acknowledgment
-            if (socket.send("ACK", 4) != Socket::Done)
+        // Send acknowledgment, even for a duplicate, so the sender stops waiting
+        if (!transport->sendMessage("ACK " + to_string(sequence)))
+        {
+            cerr << "Error sending acknowledgment!" << endl;
+        }
+        if (sequence <= receiveSequence)
+        {
+            continue;
+        }
+
+        receiveSequence = sequence;
+        receivedGame.deserialize(message.substr(static_cast<size_t>(header.tellg()) + 1)); // Deserialize game state
+        return receivedGame;
+    }
+}
+
+
+/**
+ * @brief Checks a game state received from the client against the server's own state.
+ *
+ * @param authoritative The server's game state before the client's move.
+ * @param proposed The game state the client sent.
+ * @return The server's state with the client's move applied if the proposed state is exactly that
+ *         (one legal move by the player to move), otherwise the server's state unchanged.
+ */
+Game acceptMove(const Game &authoritative, const Game &proposed)
+{
+    pair<int, int> move = {-1, -1};
+    int changed = 0;
+    if (proposed.rows == authoritative.rows && proposed.cols == authoritative.cols)
+    {
+        for (int row = 0; row < authoritative.rows; ++row)
+        {
+            for (int col = 0; col < authoritative.cols; ++col)
             {
-                cerr << "Error sending acknowledgment!" << endl;
-                gameReceived = false; // Resend if acknowledgment fails
+                if (proposed.grid[row][col] != authoritative.grid[row][col])
+                {
+                    move = {row, col};
+                    changed++;
+                }
             }
         }
     }
 
-    return receivedGame;
+    Game expected = authoritative;
+    if (changed == 1 && expected.isLegalMove(move.first, move.second))
+    {
+        expected.playerMove(move.first, move.second);
+        if (expected.serialize() == proposed.serialize())
+        {
+            return expected;
+        }
+    }
+    cerr << "Rejected an invalid move from the opponent" << endl;
+    return authoritative;
+}
+
+/**
+ * @brief Reconciles a move shown before the server confirmed it with the server's echo.
+ *
+ * @param predicted The game state shown with the move applied.
+ * @param confirmed The last state both sides agreed on, before the move.
+ * @param move The predicted move.
+ * @param authoritative The state the server echoed back.
+ * @param resend Set to true if the move was re-applied on top of the server's state and has to be
+ *        sent again.
+ * @return The predicted state if the server confirmed it; otherwise the server's state, with the
+ *         move re-applied if the server moved on without it and the move is still legal. A move the
+ *         server rejected outright is dropped, so the player can choose again.
+ */
+Game reconcileMove(const Game &predicted, const Game &confirmed, pair<int, int> move, const Game &authoritative, bool &resend)
+{
+    resend = false;
+    if (authoritative.serialize() == predicted.serialize())
+    {
+        return predicted;
+    }
+
+    countMetric(PREDICTION_ROLLBACKS);
+    Game reconciled = authoritative;
+    bool rejected = authoritative.serialize() == confirmed.serialize();
+    if (!rejected && reconciled.activeTurn == confirmed.activeTurn && reconciled.isLegalMove(move.first, move.second))
+    {
+        reconciled.playerMove(move.first, move.second);
+        resend = true;
+    }
+    return reconciled;
 }
@@ -0,0 +1,543 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This file implements 3D 4x4x4 Tic Tac Toe (Qubic) on 64-bit bitboards and the alpha-beta search
+used by the computer player. The 76 winning lines are built once as masks; full-board win checks
+compare several masks per instruction with AVX2 or SSE4.1 when the CPU supports them (checked at
+runtime), and a move only has to test the (at most seven) lines passing through its cell. The
+search forces blocks against single threats, recognizes double threats as lost, and orders moves
+by line potential.
+*/
+
+#include "qubic.hpp"
+#include "ai.hpp"
+#include "metrics.hpp"
+#include <chrono>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define QUBIC_X86 1
+#endif
+
+namespace
+{
+const int LINE_COUNT = 76;
+const int WIN_SCORE = QUBIC_WIN_SCORE;
+
+/**
+ * @brief Counts the set bits of a 64-bit word.
+ */
+int popcount64(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(value);
+#else
+    int count = 0;
+    for (; value; value &= value - 1)
+        count++;
+    return count;
+#endif
+}
+
+/**
+ * @brief Returns the index of the lowest set bit of a non-zero word.
+ */
+int lowestBit(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(value);
+#else
+    int index = 0;
+    while (!(value & 1))
+    {
+        value >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+/**
+ * @brief The 76 winning lines of the 4x4x4 cube as bitmasks, and the lines through each cell.
+ */
+struct QubicLines
+{
+    alignas(32) uint64_t masks[LINE_COUNT];
+    uint64_t byCell[64][7]; // masks of the lines through each cell
+    int countByCell[64]; // 4 for most cells, 7 for the corners and the 8 central cells
+
+    QubicLines()
+    {
+        int count = 0;
+        for (int cell = 0; cell < 64; ++cell)
+            countByCell[cell] = 0;
+
+        // Walk the 13 directions that have a positive first non-zero component
+        for (int dz = -1; dz <= 1; ++dz)
+            for (int dy = -1; dy <= 1; ++dy)
+                for (int dx = -1; dx <= 1; ++dx)
+                {
+                    if (dz < 0 || (dz == 0 && (dy < 0 || (dy == 0 && dx <= 0))))
+                        continue;
+                    for (int cell = 0; cell < 64; ++cell)
+                    {
+                        int z = cell / 16, y = (cell / 4) % 4, x = cell % 4;
+                        bool startsLine = !inside(z - dz, y - dy, x - dx) && inside(z + 3 * dz, y + 3 * dy, x + 3 * dx);
+                        if (!startsLine)
+                            continue;
+                        uint64_t mask = 0;
+                        for (int i = 0; i < 4; ++i)
+                            mask |= 1ULL << ((z + i * dz) * 16 + (y + i * dy) * 4 + (x + i * dx));
+                        masks[count++] = mask;
+                        for (int i = 0; i < 4; ++i)
+                        {
+                            int member = (z + i * dz) * 16 + (y + i * dy) * 4 + (x + i * dx);
+                            byCell[member][countByCell[member]++] = mask;
+                        }
+                    }
+                }
+    }
+
+    static bool inside(int z, int y, int x)
+    {
+        return z >= 0 && z < 4 && y >= 0 && y < 4 && x >= 0 && x < 4;
+    }
+};
+
+const QubicLines qubicLines;
+
+/**
+ * @brief Checks whether a mark just placed on a cell completed a line through it.
+ */
+bool completesLine(uint64_t stones, int cell)
+{
+    for (int i = 0; i < qubicLines.countByCell[cell]; ++i)
+    {
+        uint64_t mask = qubicLines.byCell[cell][i];
+        if ((stones & mask) == mask)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Scores a position for the player owning `own`: lines only one player can still
+ *        complete are worth more the more marks they hold.
+ */
+int evaluate(uint64_t own, uint64_t other)
+{
+    static const int weights[4] = {0, 1, 8, 64};
+    int score = 0;
+    for (int line = 0; line < LINE_COUNT; ++line)
+    {
+        uint64_t mask = qubicLines.masks[line];
+        if (!(other & mask))
+            score += weights[popcount64(own & mask)];
+        else if (!(own & mask))
+            score -= weights[popcount64(other & mask)];
+    }
+    return score;
+}
+
+/**
+ * @brief Scores a move for ordering by the potential of the lines through its cell.
+ */
+int movePotential(uint64_t own, uint64_t other, int cell)
+{
+    int potential = 0;
+    for (int i = 0; i < qubicLines.countByCell[cell]; ++i)
+    {
+        uint64_t mask = qubicLines.byCell[cell][i];
+        if (!(other & mask))
+            potential += 1 << (2 * popcount64(own & mask));
+        if (!(own & mask))
+            potential += 1 << (2 * popcount64(other & mask));
+    }
+    return potential;
+}
+
+enum BOUND {
+    EXACT,
+    LOWER,
+    UPPER
+};
+
+struct TableEntry
+{
+    uint64_t own = 0; // marks of the player to move
+    uint64_t other = 0; // marks of the opponent
+    int score = 0; // search score, wins stored relative to this node
+    int depth = -1; // remaining depth searched, -1 if empty
+    int cell = -1; // best move found
+    BOUND bound = EXACT;
+};
+
+/**
+ * @brief Iterative deepening alpha-beta search over a `QubicBoard`.
+ */
+class QubicSearch
+{
+public:
+    QubicSearch(const QubicLimits &limits) : limits(limits), table(1 << 18)
+    {
+        start = chrono::steady_clock::now();
+    }
+
+    const QubicLimits &limits;
+    vector<TableEntry> table;
+    uint64_t nodes = 0;
+    bool aborted = false;
+    chrono::steady_clock::time_point start;
+
+    double elapsed() const
+    {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+
+    TableEntry &entry(uint64_t own, uint64_t other)
+    {
+        uint64_t hash = (own * 0x9E3779B97F4A7C15ULL) ^ (other * 0xC2B2AE3D27D4EB4FULL);
+        return table[(hash ^ (hash >> 29)) & (table.size() - 1)];
+    }
+
+    /**
+     * @brief Lists the moves worth searching, best first. A single opponent threat leaves
+     *        only the block.
+     */
+    int orderedMoves(uint64_t own, uint64_t other, uint64_t candidates, int firstCell, int *moves)
+    {
+        int count = 0, potentials[64];
+        for (; candidates; candidates &= candidates - 1)
+        {
+            int cell = lowestBit(candidates);
+            int potential = cell == firstCell ? 1 << 30 : movePotential(own, other, cell);
+            int i = count++;
+            while (i > 0 && potentials[i - 1] < potential) // insertion sort, highest potential first
+            {
+                moves[i] = moves[i - 1];
+                potentials[i] = potentials[i - 1];
+                i--;
+            }
+            moves[i] = cell;
+            potentials[i] = potential;
+        }
+        return count;
+    }
+
+    int search(uint64_t own, uint64_t other, int depth, int alpha, int beta, int ply)
+    {
+        nodes++;
+        if (((nodes & 4095) == 0 && (elapsed() > limits.maxSeconds || (limits.stop && limits.stop->load(memory_order_relaxed)))) ||
+            nodes >= limits.maxNodes)
+            aborted = true;
+        if (aborted)
+            return 0;
+
+        uint64_t empty = ~(own | other);
+        if (qubicThreats(own, other) & empty)
+            return WIN_SCORE - ply - 1; // we complete a line next move
+        uint64_t blocks = qubicThreats(other, own) & empty;
+        if (popcount64(blocks) >= 2)
+            return -(WIN_SCORE - ply - 2); // two open threats cannot both be blocked
+        if (!empty)
+            return 0;
+        if (depth <= 0 && !blocks)
+            return evaluate(own, other);
+
+        TableEntry &stored = entry(own, other);
+        int firstCell = -1;
+        if (stored.own == own && stored.other == other && stored.depth >= 0)
+        {
+            firstCell = stored.cell;
+            int score = fromTable(stored.score, ply);
+            if (stored.depth >= depth &&
+                (stored.bound == EXACT || (stored.bound == LOWER && score >= beta) || (stored.bound == UPPER && score <= alpha)))
+                return score;
+        }
+
+        int moves[64];
+        int count = orderedMoves(own, other, blocks ? blocks : empty, firstCell, moves);
+        int nextDepth = blocks ? depth : depth - 1; // forced blocks do not use up depth
+        int best = -WIN_SCORE, bestCell = moves[0], originalAlpha = alpha;
+        for (int i = 0; i < count; ++i)
+        {
+            int score = -search(other, own | (1ULL << moves[i]), nextDepth, -beta, -alpha, ply + 1);
+            if (aborted)
+                return 0;
+            if (score > best)
+            {
+                best = score;
+                bestCell = moves[i];
+            }
+            alpha = max(alpha, score);
+            if (alpha >= beta)
+                break;
+        }
+
+        stored.own = own;
+        stored.other = other;
+        stored.depth = depth;
+        stored.cell = bestCell;
+        stored.score = toTable(best, ply);
+        stored.bound = best <= originalAlpha ? UPPER : (best >= beta ? LOWER : EXACT);
+        return best;
+    }
+
+private:
+    // Win scores are stored relative to the node so they stay correct when reached at another ply
+    static int toTable(int score, int ply)
+    {
+        if (score > WIN_SCORE - 1000)
+            return score + ply;
+        if (score < -(WIN_SCORE - 1000))
+            return score - ply;
+        return score;
+    }
+
+    static int fromTable(int score, int ply)
+    {
+        if (score > WIN_SCORE - 1000)
+            return score - ply;
+        if (score < -(WIN_SCORE - 1000))
+            return score + ply;
+        return score;
+    }
+};
+}
+
+namespace
+{
+typedef bool (*LineChecker)(uint64_t);
+
+/**
+ * @brief Checks the lines one mask at a time.
+ */
+bool hasLineScalar(uint64_t stones)
+{
+    for (int line = 0; line < LINE_COUNT; ++line)
+    {
+        if ((stones & qubicLines.masks[line]) == qubicLines.masks[line])
+            return true;
+    }
+    return false;
+}
+
+#ifdef QUBIC_X86
+/**
+ * @brief Checks the lines 2 masks at a time with SSE4.1.
+ */
+__attribute__((target("sse4.1"))) bool hasLineSse41(uint64_t stones)
+{
+    __m128i board = _mm_set1_epi64x(static_cast<long long>(stones));
+    for (int line = 0; line < LINE_COUNT; line += 2)
+    {
+        __m128i masks = _mm_load_si128(reinterpret_cast<const __m128i *>(&qubicLines.masks[line]));
+        __m128i hits = _mm_cmpeq_epi64(_mm_and_si128(board, masks), masks);
+        if (_mm_movemask_epi8(hits))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Checks the lines 4 masks at a time with AVX2.
+ */
+__attribute__((target("avx2"))) bool hasLineAvx2(uint64_t stones)
+{
+    __m256i board = _mm256_set1_epi64x(static_cast<long long>(stones));
+    for (int line = 0; line < LINE_COUNT; line += 4)
+    {
+        __m256i masks = _mm256_load_si256(reinterpret_cast<const __m256i *>(&qubicLines.masks[line]));
+        __m256i hits = _mm256_cmpeq_epi64(_mm256_and_si256(board, masks), masks);
+        if (_mm256_movemask_epi8(hits))
+            return true;
+    }
+    return false;
+}
+#endif
+
+/**
+ * @brief Picks the fastest line checker the CPU supports, once, on first use.
+ */
+LineChecker lineChecker()
+{
+    static const LineChecker selected = []() -> LineChecker {
+#ifdef QUBIC_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return hasLineAvx2;
+        if (__builtin_cpu_supports("sse4.1"))
+            return hasLineSse41;
+#endif
+        return hasLineScalar;
+    }();
+    return selected;
+}
+}
+
+/**
+ * @brief Checks whether a set of marks contains a complete line.
+ *
+ * @param stones One player's marks.
+ * @return True if any of the 76 lines is fully covered.
+ */
+bool qubicHasLine(uint64_t stones)
+{
+    return lineChecker()(stones);
+}
+
+/**
+ * @brief Finds the cells where a player would complete a line with one more mark.
+ *
+ * @param own The player's marks.
+ * @param other The opponent's marks.
+ * @return A mask of the completing cells.
+ */
+uint64_t qubicThreats(uint64_t own, uint64_t other)
+{
+    uint64_t threats = 0;
+    for (int line = 0; line < LINE_COUNT; ++line)
+    {
+        uint64_t mask = qubicLines.masks[line];
+        if (!(other & mask) && popcount64(own & mask) == 3)
+            threats |= mask & ~own;
+    }
+    return threats;
+}
+
+/**
+ * @brief Builds the bitboard position from a game in the QUBIC variant.
+ */
+QubicBoard QubicBoard::fromGame(const Game &game)
+{
+    QubicBoard board = {};
+    for (int row = 0; row < 8; ++row)
+    {
+        for (int col = 0; col < 8; ++col)
+        {
+            if (game.grid[row][col] != 0)
+                board.stones[game.grid[row][col] - 1] |= 1ULL << qubicCellIndex(row, col);
+        }
+    }
+    board.toMove = game.activeTurn == X ? 0 : 1;
+
+    if (qubicHasLine(board.stones[0]))
+        board.status = X_WIN;
+    else if (qubicHasLine(board.stones[1]))
+        board.status = O_WIN;
+    else if ((board.stones[0] | board.stones[1]) == ~0ULL)
+        board.status = DRAW;
+    else
+        board.status = PLAYING;
+    return board;
+}
+
+/**
+ * @brief Plays a cell for the player to move and updates the outcome.
+ */
+void QubicBoard::play(int cell)
+{
+    stones[toMove] |= 1ULL << cell;
+    if (completesLine(stones[toMove], cell))
+        status = toMove == 0 ? X_WIN : O_WIN;
+    else if ((stones[0] | stones[1]) == ~0ULL)
+        status = DRAW;
+    toMove ^= 1;
+}
+
+/**
+ * @brief Converts a cell of the 8x8 game grid to a cube cell index (layer * 16 + row * 4 + col).
+ */
+int qubicCellIndex(int row, int col)
+{
+    int layer = (row / 4) * 2 + col / 4;
+    return layer * 16 + (row % 4) * 4 + col % 4;
+}
+
+/**
+ * @brief Converts a cube cell index to its row and column on the 8x8 game grid.
+ */
+pair<int, int> qubicCellPosition(int cell)
+{
+    int layer = cell / 16;
+    return {(layer / 2) * 4 + (cell / 4) % 4, (layer % 2) * 4 + cell % 4};
+}
+
+/**
+ * @brief Searches a Qubic position with iterative deepening until the time budget runs out.
+ *
+ * @param board The position to search. It must still be in play.
+ * @param limits Time and depth budgets.
+ * @return The best move from the deepest completed iteration and search statistics.
+ */
+QubicResult searchQubic(const QubicBoard &board, const QubicLimits &limits)
+{
+    QubicResult result;
+    QubicSearch search(limits);
+    uint64_t own = board.stones[board.toMove], other = board.stones[board.toMove ^ 1];
+    uint64_t empty = ~(own | other);
+
+    // Complete a line, or block the opponent's, without searching
+    uint64_t forced = qubicThreats(own, other) & empty;
+    if (!forced)
+        forced = qubicThreats(other, own) & empty;
+    if (forced)
+    {
+        result.cell = lowestBit(forced);
+        return result;
+    }
+
+    int moves[64];
+    search.orderedMoves(own, other, empty, -1, moves);
+    result.cell = moves[0]; // played if not even the first iteration completes
+    for (int depth = 1; depth <= limits.maxDepth; ++depth)
+    {
+        int count = search.orderedMoves(own, other, empty, result.cell, moves);
+        int alpha = -WIN_SCORE - 1, bestCell = moves[0];
+        for (int i = 0; i < count; ++i)
+        {
+            int score = -search.search(other, own | (1ULL << moves[i]), depth - 1, -WIN_SCORE - 1, -alpha, 1);
+            if (search.aborted)
+                break;
+            if (score > alpha)
+            {
+                alpha = score;
+                bestCell = moves[i];
+            }
+        }
+        if (search.aborted)
+            break;
+
+        result.cell = bestCell;
+        result.score = alpha;
+        result.depth = depth;
+        if (alpha > WIN_SCORE - 1000 || alpha < -(WIN_SCORE - 1000))
+            break; // the outcome is decided, searching deeper will not change it
+    }
+
+    result.nodes = search.nodes;
+    result.seconds = search.elapsed();
+    return result;
+}
+
+/**
+ * @brief Chooses the computer's move in the QUBIC variant.
+ *
+ * @param game The current game state.
+ * @param limits Search budgets for the move.
+ * @return The row and column of the chosen move on the 8x8 grid.
+ */
+pair<int, int> qubicMove(const Game &game, const QubicLimits &limits)
+{
+    QubicResult result = searchQubic(QubicBoard::fromGame(game), limits);
+    countMetric(QUBIC_NODES, result.nodes);
+    if (logEngineStats)
+    {
+        cout << "Qubic search: depth " << result.depth << ", " << result.nodes << " nodes in "
+             << result.seconds * 1000 << " ms (score " << result.score << ")" << endl;
+    }
+    return qubicCellPosition(result.cell);
+}
@@ -0,0 +1,365 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This file implements the reliability layer of the UDP transport. Each datagram starts with a
+one-byte type: 'D' carries a message (sequence number and payload), 'A' acknowledges (cumulative
+sequence number and a 64-bit bitmap of the messages received past it) and 'P' is a keep-alive.
+A worker thread receives datagrams, answers every data datagram with an acknowledgment, and
+retransmits unacknowledged messages when their timer expires. The timer follows the smoothed
+round-trip time and its variance (RFC 6298), doubling for each retransmission of a message.
+*/
+
+#include "reliable.hpp"
+#include "metrics.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+const uint64_t MAX_WAIT_MICROS = 10000; // longest the worker waits for a datagram between timer checks
+
+void put32(string &out, uint32_t value)
+{
+    char bytes[4];
+    memcpy(bytes, &value, 4);
+    out.append(bytes, 4);
+}
+
+void put64(string &out, uint64_t value)
+{
+    char bytes[8];
+    memcpy(bytes, &value, 8);
+    out.append(bytes, 8);
+}
+
+uint32_t get32(const string &in, size_t offset)
+{
+    uint32_t value;
+    memcpy(&value, in.data() + offset, 4);
+    return value;
+}
+
+uint64_t get64(const string &in, size_t offset)
+{
+    uint64_t value;
+    memcpy(&value, in.data() + offset, 8);
+    return value;
+}
+}
+
+/**
+ * @brief Starts a channel over a datagram link.
+ *
+ * @param link The link to the peer. It must outlive the channel.
+ * @param ordered Deliver messages in sequence order instead of as they arrive.
+ */
+ReliableChannel::ReliableChannel(DatagramLink &link, bool ordered) : link(link), ordered(ordered)
+{
+    lastHeardAt = metricsClockMicros();
+    lastSentAt = lastHeardAt;
+    worker = thread(&ReliableChannel::run, this);
+}
+
+ReliableChannel::~ReliableChannel()
+{
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    worker.join();
+}
+
+/**
+ * @brief Sends a message, waiting while the window of unacknowledged messages is full.
+ *
+ * @return False if the message is too large or the peer has stopped responding.
+ */
+bool ReliableChannel::send(const string &message)
+{
+    if (message.size() + 5 > MAX_DATAGRAM_SIZE)
+    {
+        return false;
+    }
+    unique_lock<mutex> guard(lock);
+    // The window spans sequence numbers, not a message count, so the receiver's bitmap can cover it
+    windowOpen.wait(guard, [this] { return broken || inFlight.empty() || nextSequence - inFlight.begin()->first < RELIABLE_WINDOW; });
+    if (broken)
+    {
+        return false;
+    }
+
+    uint32_t sequence = nextSequence++;
+    string datagram = "D";
+    put32(datagram, sequence);
+    datagram += message;
+    uint64_t now = metricsClockMicros();
+    inFlight[sequence] = {datagram, now, now, 1};
+    counters.sent++;
+    transmit(datagram);
+    return true;
+}
+
+/**
+ * @brief Waits for the next message from the peer.
+ *
+ * @return False once the peer has stopped responding and every message received before has been
+ *         returned.
+ */
+bool ReliableChannel::receive(string &message)
+{
+    unique_lock<mutex> guard(lock);
+    messageReady.wait(guard, [this] { return broken || !deliveredMessages.empty(); });
+    if (deliveredMessages.empty())
+    {
+        return false;
+    }
+    message = move(deliveredMessages.front());
+    deliveredMessages.pop_front();
+    return true;
+}
+
+bool ReliableChannel::failed() const
+{
+    lock_guard<mutex> guard(lock);
+    return broken;
+}
+
+ReliableStats ReliableChannel::stats() const
+{
+    lock_guard<mutex> guard(lock);
+    ReliableStats snapshot = counters;
+    snapshot.rtoMicros = rto;
+    return snapshot;
+}
+
+/**
+ * @brief Worker loop: waits for datagrams until the next timer is due, then services the timers.
+ */
+void ReliableChannel::run()
+{
+    string datagram;
+    while (true)
+    {
+        uint64_t wait = MAX_WAIT_MICROS;
+        {
+            lock_guard<mutex> guard(lock);
+            if (stopping)
+                return;
+            uint64_t now = metricsClockMicros();
+            for (const auto &entry : inFlight)
+            {
+                const Outgoing &outgoing = entry.second;
+                uint64_t due = retransmitDue(outgoing);
+                wait = min(wait, due > now ? due - now : 0);
+            }
+        }
+
+        if (link.receiveDatagram(datagram, wait))
+        {
+            handleDatagram(datagram);
+        }
+        serviceTimers();
+    }
+}
+
+/**
+ * @brief Decodes one datagram from the peer; malformed datagrams are ignored.
+ */
+void ReliableChannel::handleDatagram(const string &datagram)
+{
+    lock_guard<mutex> guard(lock);
+    lastHeardAt = metricsClockMicros();
+    if (datagram.empty())
+    {
+        return;
+    }
+    if (datagram[0] == 'D' && datagram.size() >= 5)
+    {
+        handleData(get32(datagram, 1), datagram.substr(5));
+    }
+    else if (datagram[0] == 'A' && datagram.size() >= 13)
+    {
+        handleAck(get32(datagram, 1), get64(datagram, 5));
+    }
+    // 'P' keep-alives only refresh lastHeardAt
+}
+
+/**
+ * @brief Delivers a new message (or holds it back in ordered mode) and acknowledges it.
+ *
+ * Called with the lock held.
+ */
+void ReliableChannel::handleData(uint32_t sequence, const string &payload)
+{
+    if (sequence > cumulative + RELIABLE_WINDOW)
+    {
+        return; // beyond the window the sender may use; it will be sent again
+    }
+    if (sequence <= cumulative || receivedAhead.count(sequence))
+    {
+        counters.duplicates++; // our acknowledgment was lost or is late; acknowledge again
+        sendAck();
+        return;
+    }
+
+    receivedAhead.insert(sequence);
+    if (ordered)
+    {
+        heldBack[sequence] = payload;
+    }
+    else
+    {
+        deliveredMessages.push_back(payload);
+        counters.delivered++;
+    }
+    while (!receivedAhead.empty() && *receivedAhead.begin() == cumulative + 1)
+    {
+        receivedAhead.erase(receivedAhead.begin());
+        cumulative++;
+        if (ordered)
+        {
+            deliveredMessages.push_back(move(heldBack[cumulative]));
+            heldBack.erase(cumulative);
+            counters.delivered++;
+        }
+    }
+    sendAck();
+    messageReady.notify_all();
+}
+
+/**
+ * @brief Retires acknowledged messages and updates the round-trip estimate.
+ *
+ * Only messages sent once give round-trip samples, since the acknowledgment of a retransmitted
+ * message may belong to either copy. Called with the lock held.
+ */
+void ReliableChannel::handleAck(uint32_t cumulativeAck, uint64_t bitmap)
+{
+    uint64_t now = metricsClockMicros();
+    bool retired = false;
+    for (auto it = inFlight.begin(); it != inFlight.end();)
+    {
+        uint32_t sequence = it->first;
+        bool acknowledged = sequence <= cumulativeAck ||
+                            (sequence - cumulativeAck - 1 < 64 && (bitmap >> (sequence - cumulativeAck - 1)) & 1);
+        if (!acknowledged)
+        {
+            ++it;
+            continue;
+        }
+        if (it->second.transmissions == 1)
+        {
+            uint64_t sample = now - it->second.firstSent;
+            if (smoothedRtt == 0)
+            {
+                smoothedRtt = sample;
+                rttVariance = sample / 2;
+            }
+            else
+            {
+                uint64_t error = sample > smoothedRtt ? sample - smoothedRtt : smoothedRtt - sample;
+                rttVariance = (3 * rttVariance + error) / 4;
+                smoothedRtt = (7 * smoothedRtt + sample) / 8;
+            }
+            rto = min(max(smoothedRtt + 4 * rttVariance, MIN_RTO_MICROS), MAX_RTO_MICROS);
+        }
+        it = inFlight.erase(it);
+        retired = true;
+    }
+    if (retired)
+    {
+        windowOpen.notify_all();
+    }
+}
+
+/**
+ * @brief Retransmits overdue messages, sends a keep-alive when idle and gives up on a silent peer.
+ */
+void ReliableChannel::serviceTimers()
+{
+    lock_guard<mutex> guard(lock);
+    if (broken)
+    {
+        return;
+    }
+    uint64_t now = metricsClockMicros();
+    if (now - lastHeardAt > PEER_TIMEOUT_MICROS)
+    {
+        fail();
+        return;
+    }
+
+    for (auto &entry : inFlight)
+    {
+        Outgoing &outgoing = entry.second;
+        if (now - outgoing.firstSent > PEER_TIMEOUT_MICROS)
+        {
+            fail(); // the peer answers, but never this message
+            return;
+        }
+        uint64_t due = retransmitDue(outgoing);
+        if (now >= due)
+        {
+            outgoing.lastSent = now;
+            outgoing.transmissions++;
+            counters.retransmits++;
+            countMetric(NETWORK_RETRANSMITS);
+            transmit(outgoing.datagram);
+        }
+    }
+    if (now - lastSentAt >= HEARTBEAT_MICROS)
+    {
+        transmit("P");
+    }
+}
+
+/**
+ * @brief Returns when a message is next due for retransmission: the timeout doubles with each
+ *        transmission (up to MAX_BACKOFF_DOUBLINGS times), capped at MAX_RTO_MICROS. Called with
+ *        the lock held.
+ */
+uint64_t ReliableChannel::retransmitDue(const Outgoing &outgoing) const
+{
+    int doublings = min(outgoing.transmissions - 1, MAX_BACKOFF_DOUBLINGS);
+    return outgoing.lastSent + min(rto << doublings, MAX_RTO_MICROS);
+}
+
+/**
+ * @brief Acknowledges everything received so far. Called with the lock held.
+ */
+void ReliableChannel::sendAck()
+{
+    uint64_t bitmap = 0;
+    for (uint32_t sequence : receivedAhead)
+    {
+        bitmap |= 1ULL << (sequence - cumulative - 1); // received messages are within the window
+    }
+    string datagram = "A";
+    put32(datagram, cumulative);
+    put64(datagram, bitmap);
+    transmit(datagram);
+}
+
+/**
+ * @brief Sends a datagram, failing the channel if the link is broken. Called with the lock held.
+ */
+void ReliableChannel::transmit(const string &datagram)
+{
+    lastSentAt = metricsClockMicros();
+    if (!link.sendDatagram(datagram))
+    {
+        fail();
+    }
+}
+
+/**
+ * @brief Marks the channel broken and wakes every waiting sender and receiver.
+ */
+void ReliableChannel::fail()
+{
+    broken = true;
+    windowOpen.notify_all();
+    messageReady.notify_all();
+}
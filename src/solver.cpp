@@ -0,0 +1,513 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This file implements the proof-number solver used by the EXPERT difficulty. It runs depth-first
+proof-number search (df-pn) over a compact copy of the board, keeps proof and disproof numbers in a
+fixed-size transposition table, and prunes moves using threats: a player facing an immediate win
+must block it, and on large boards the attacker only considers moves that threaten to win next
+turn (a victory-by-continuous-threats search), which keeps long forced sequences cheap to prove.
+*/
+
+#include "solver.hpp"
+#include "ai.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+const uint32_t INF = 1u << 30; // proof/disproof number of a solved node
+
+/**
+ * @brief Adds two proof numbers, saturating at INF.
+ */
+uint32_t addNumbers(uint32_t a, uint32_t b)
+{
+    uint64_t sum = static_cast<uint64_t>(a) + b;
+    return sum >= INF ? INF : static_cast<uint32_t>(sum);
+}
+
+/**
+ * @brief Returns the hash key contribution of a mark on a cell (splitmix64 of the cell and side).
+ */
+uint64_t zobrist(int cell, int side)
+{
+    uint64_t z = static_cast<uint64_t>(cell * 2 + side + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+const uint64_t SIDE_KEY = 0x2545F4914F6CDD1DULL; // toggled when the player to move changes
+
+// Result of looking at a node before expanding it
+enum NODEOUTCOME {
+    EXPAND, // search the generated moves
+    TO_MOVE_WINS, // the player to move completes a line now
+    TO_MOVE_LOSES, // the opponent has more winning cells than can be blocked
+    NO_WIN // board full, or the attacker has no threats left
+};
+
+struct TableEntry
+{
+    uint64_t key; // position hash, 0 if the slot is empty
+    uint32_t pn; // proof number
+    uint32_t dn; // disproof number
+    uint64_t work; // nodes spent below this position, used for replacement
+};
+
+/**
+ * @brief Fixed-size transposition table of proof and disproof numbers.
+ *
+ * Each key maps to a bucket of two slots. When both are taken, the slot that cost less work
+ * to compute is replaced, so expensive results survive longer.
+ */
+class ProofTable
+{
+public:
+    ProofTable(size_t megabytes)
+    {
+        size_t slots = 2;
+        while (slots * 2 * sizeof(TableEntry) <= megabytes * 1024 * 1024)
+            slots *= 2;
+        entries.assign(slots, TableEntry{0, 1, 1, 0});
+        bucketMask = slots / 2 - 1;
+    }
+
+    bool lookup(uint64_t key, uint32_t &pn, uint32_t &dn) const
+    {
+        const TableEntry *bucket = &entries[(key & bucketMask) * 2];
+        for (int i = 0; i < 2; ++i)
+        {
+            if (bucket[i].key == key)
+            {
+                pn = bucket[i].pn;
+                dn = bucket[i].dn;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void store(uint64_t key, uint32_t pn, uint32_t dn, uint64_t work)
+    {
+        TableEntry *bucket = &entries[(key & bucketMask) * 2];
+        TableEntry *slot = bucket[0].work <= bucket[1].work ? &bucket[0] : &bucket[1];
+        for (int i = 0; i < 2; ++i)
+        {
+            if (bucket[i].key == key)
+                slot = &bucket[i];
+        }
+        *slot = TableEntry{key, pn, dn, work};
+    }
+
+    size_t memoryBytes() const
+    {
+        return entries.size() * sizeof(TableEntry);
+    }
+
+private:
+    vector<TableEntry> entries; // buckets of two slots
+    uint64_t bucketMask; // number of buckets - 1
+};
+
+/**
+ * @brief Compact board used by the solver, with per-line mark counts updated on every move.
+ */
+class SolverBoard
+{
+public:
+    const LineTable &lines;
+    vector<uint8_t> cells; // 0 empty, 1 X, 2 O
+    vector<uint8_t> lineCount[2]; // marks of X (0) and O (1) in each line
+    uint64_t hash = 0; // zobrist hash of the position and player to move
+    int toMove; // 0 for X, 1 for O
+    int empties = 0; // number of empty cells
+
+    SolverBoard(const Game &game) : lines(*game.lines)
+    {
+        cells.assign(game.rows * game.cols, 0);
+        lineCount[0].assign(lines.count, 0);
+        lineCount[1].assign(lines.count, 0);
+        toMove = game.activeTurn == X ? 0 : 1;
+        if (toMove == 1)
+            hash ^= SIDE_KEY;
+
+        for (int row = 0; row < game.rows; ++row)
+        {
+            for (int col = 0; col < game.cols; ++col)
+            {
+                int cell = row * game.cols + col;
+                if (game.grid[row][col] == 0)
+                {
+                    empties++;
+                    continue;
+                }
+                int side = game.grid[row][col] - 1;
+                cells[cell] = static_cast<uint8_t>(side + 1);
+                hash ^= zobrist(cell, side);
+                for (int line : lines.linesByCell[cell])
+                    lineCount[side][line]++;
+            }
+        }
+    }
+
+    /**
+     * @brief Places a mark for the player to move and passes the turn.
+     */
+    void play(int cell)
+    {
+        cells[cell] = static_cast<uint8_t>(toMove + 1);
+        for (int line : lines.linesByCell[cell])
+            lineCount[toMove][line]++;
+        hash ^= zobrist(cell, toMove) ^ SIDE_KEY;
+        empties--;
+        toMove ^= 1;
+    }
+
+    /**
+     * @brief Takes back a mark placed by `play`.
+     */
+    void undo(int cell)
+    {
+        toMove ^= 1;
+        empties++;
+        hash ^= zobrist(cell, toMove) ^ SIDE_KEY;
+        for (int line : lines.linesByCell[cell])
+            lineCount[toMove][line]--;
+        cells[cell] = 0;
+    }
+
+    /**
+     * @brief Returns the hash the position would have after the player to move plays a cell.
+     */
+    uint64_t childHash(int cell) const
+    {
+        return hash ^ zobrist(cell, toMove) ^ SIDE_KEY;
+    }
+
+    /**
+     * @brief Collects the distinct empty cells that would complete a line for a side.
+     */
+    void winningCells(int side, vector<int> &out) const
+    {
+        out.clear();
+        for (int line = 0; line < lines.count; ++line)
+        {
+            if (lineCount[side][line] != lines.length - 1 || lineCount[side ^ 1][line] != 0)
+                continue;
+            const int *lineCells = &lines.cells[line * lines.length];
+            for (int i = 0; i < lines.length; ++i)
+            {
+                if (cells[lineCells[i]] == 0 && find(out.begin(), out.end(), lineCells[i]) == out.end())
+                    out.push_back(lineCells[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Checks whether marking a cell would leave a side one move away from winning.
+     */
+    bool createsThreat(int cell, int side) const
+    {
+        for (int line : lines.linesByCell[cell])
+        {
+            if (lineCount[side][line] == lines.length - 2 && lineCount[side ^ 1][line] == 0)
+                return true;
+        }
+        return false;
+    }
+};
+
+/**
+ * @brief Depth-first proof-number search over a `SolverBoard`.
+ */
+class ProofSearch
+{
+public:
+    ProofSearch(SolverBoard &board, const SolverLimits &limits)
+        : board(board), limits(limits), table(limits.tableMegabytes), attacker(board.toMove)
+    {
+        start = chrono::steady_clock::now();
+    }
+
+    SolverBoard &board;
+    const SolverLimits &limits;
+    ProofTable table;
+    int attacker; // side trying to prove a win
+    uint64_t nodes = 0; // nodes expanded so far
+    bool aborted = false; // set when the node or time budget runs out
+    int rootMove = -1; // best root move found so far
+    chrono::steady_clock::time_point start;
+
+    /**
+     * @brief Expands a node in the search, refining its proof and disproof numbers until
+     *        one of them reaches its threshold.
+     */
+    void mid(uint32_t thpn, uint32_t thdn, uint32_t &pn, uint32_t &dn, int depth)
+    {
+        nodes++;
+        if ((nodes & 1023) == 0 && chrono::duration<double>(chrono::steady_clock::now() - start).count() > limits.maxSeconds)
+            aborted = true;
+        if (nodes > limits.maxNodes)
+            aborted = true;
+
+        bool orNode = board.toMove == attacker;
+        vector<int> moves;
+        int winningCell = -1;
+        NODEOUTCOME outcome = generateMoves(orNode, moves, winningCell);
+
+        if (outcome != EXPAND)
+        {
+            bool attackerWins = outcome != NO_WIN && (outcome == TO_MOVE_WINS) == orNode;
+            pn = attackerWins ? 0 : INF;
+            dn = attackerWins ? INF : 0;
+            if (depth == 0)
+                rootMove = winningCell;
+            table.store(board.hash, pn, dn, 1);
+            return;
+        }
+
+        uint64_t startNodes = nodes;
+        while (true)
+        {
+            // Gather the children's current numbers and the two most promising children
+            uint32_t minimum = INF + 1, second = INF + 1, total = 0;
+            int best = 0;
+            uint32_t bestPn = 1, bestDn = 1;
+            for (size_t i = 0; i < moves.size(); ++i)
+            {
+                uint32_t childPn = 1, childDn = 1;
+                table.lookup(board.childHash(moves[i]), childPn, childDn);
+
+                uint32_t selectValue = orNode ? childPn : childDn;
+                total = addNumbers(total, orNode ? childDn : childPn);
+                if (selectValue < minimum)
+                {
+                    second = minimum;
+                    minimum = selectValue;
+                    best = static_cast<int>(i);
+                    bestPn = childPn;
+                    bestDn = childDn;
+                }
+                else if (selectValue < second)
+                {
+                    second = selectValue;
+                }
+            }
+            pn = orNode ? minimum : total;
+            dn = orNode ? total : minimum;
+            if (depth == 0)
+                rootMove = moves[best];
+
+            if (pn >= thpn || dn >= thdn || aborted)
+                break;
+
+            // Search the most promising child with thresholds that send it back once it stops being the best
+            uint32_t childThpn, childThdn;
+            if (orNode)
+            {
+                childThpn = min<uint32_t>(thpn, addNumbers(second, 1));
+                childThdn = thdn >= INF ? INF : thdn - dn + bestDn;
+            }
+            else
+            {
+                childThdn = min<uint32_t>(thdn, addNumbers(second, 1));
+                childThpn = thpn >= INF ? INF : thpn - pn + bestPn;
+            }
+
+            board.play(moves[best]);
+            mid(childThpn, childThdn, bestPn, bestDn, depth + 1);
+            board.undo(moves[best]);
+        }
+
+        table.store(board.hash, pn, dn, nodes - startNodes + 1);
+    }
+
+private:
+    /**
+     * @brief Generates the moves worth searching at a node, applying the threat rules.
+     *
+     * @return TO_MOVE_WINS if the player to move wins immediately, TO_MOVE_LOSES if the opponent
+     *         has two winning cells, NO_WIN if the board is full or the attacker has run out of
+     *         threats, else EXPAND.
+     */
+    NODEOUTCOME generateMoves(bool orNode, vector<int> &moves, int &winningCell)
+    {
+        vector<int> wins;
+        board.winningCells(board.toMove, wins);
+        if (!wins.empty())
+        {
+            winningCell = wins[0];
+            return TO_MOVE_WINS;
+        }
+
+        board.winningCells(board.toMove ^ 1, wins);
+        if (wins.size() >= 2)
+            return TO_MOVE_LOSES; // only one of the opponent's threats can be blocked
+        if (wins.size() == 1)
+        {
+            if (orNode && limits.threatsOnly && !board.createsThreat(wins[0], attacker))
+                return NO_WIN; // forced block that does not keep up the attack
+            moves.push_back(wins[0]);
+            return EXPAND;
+        }
+
+        for (int cell = 0; cell < static_cast<int>(board.cells.size()); ++cell)
+        {
+            if (board.cells[cell] != 0)
+                continue;
+            if (orNode && limits.threatsOnly && !board.createsThreat(cell, attacker))
+                continue;
+            moves.push_back(cell);
+        }
+        return moves.empty() ? NO_WIN : EXPAND;
+    }
+};
+
+/**
+ * @brief Picks a move by scoring each empty cell on the lines it could still complete.
+ *
+ * Used when no forced win is found on boards too large for minimax. Cells on lines the computer
+ * is building score highest, followed by cells on lines the opponent is building; an opponent's
+ * immediate win is always blocked.
+ */
+pair<int, int> heuristicMove(const Game &game)
+{
+    SolverBoard board(game);
+    int self = board.toMove;
+
+    vector<int> threats;
+    board.winningCells(self ^ 1, threats);
+    if (!threats.empty())
+        return {threats[0] / game.cols, threats[0] % game.cols};
+
+    double bestScore = -1;
+    int bestCell = -1;
+    double center = (game.rows - 1) / 2.0;
+    for (int cell = 0; cell < static_cast<int>(board.cells.size()); ++cell)
+    {
+        if (board.cells[cell] != 0)
+            continue;
+
+        double cellScore = 0;
+        for (int line : board.lines.linesByCell[cell])
+        {
+            int own = board.lineCount[self][line];
+            int other = board.lineCount[self ^ 1][line];
+            if (other == 0)
+                cellScore += (own + 1) * (own + 1) * (own + 1);
+            if (own == 0)
+                cellScore += 0.9 * other * other * other;
+        }
+        // Prefer central cells when scores tie
+        double rowOffset = cell / game.cols - center, colOffset = cell % game.cols - center;
+        cellScore -= 0.001 * (rowOffset * rowOffset + colOffset * colOffset);
+
+        if (cellScore > bestScore)
+        {
+            bestScore = cellScore;
+            bestCell = cell;
+        }
+    }
+    return {bestCell / game.cols, bestCell % game.cols};
+}
+}
+
+/**
+ * @brief Returns solver limits suited to the board being played.
+ *
+ * @param game The game whose board will be solved.
+ * @return Full-width search on small boards, threat-only search on large ones.
+ */
+SolverLimits defaultSolverLimits(const Game &game)
+{
+    SolverLimits limits;
+    if (game.rows * game.cols > 16)
+    {
+        limits.threatsOnly = true;
+        limits.tableMegabytes = 64;
+    }
+    else
+    {
+        limits.tableMegabytes = 1;
+    }
+    return limits;
+}
+
+/**
+ * @brief Tries to prove that the player to move has a forced win.
+ *
+ * @param game The position to solve.
+ * @param limits Node budget, time budget, table size and pruning mode.
+ * @return The outcome, the winning move if one was proven, and search statistics. With
+ *         `threatsOnly` set, DISPROVEN only means no win by continuous threats exists.
+ */
+SolveResult solvePosition(const Game &game, const SolverLimits &limits)
+{
+    SolveResult result;
+    if (game.status != PLAYING)
+    {
+        result.value = DISPROVEN;
+        return result;
+    }
+
+    SolverBoard board(game);
+    ProofSearch search(board, limits);
+    uint32_t pn, dn;
+    search.mid(INF, INF, pn, dn, 0);
+
+    if (pn == 0)
+        result.value = PROVEN_WIN;
+    else if (dn == 0)
+        result.value = DISPROVEN;
+    else
+        result.value = UNKNOWN;
+
+    if (result.value == PROVEN_WIN && search.rootMove >= 0)
+        result.move = {search.rootMove / game.cols, search.rootMove % game.cols};
+    result.nodes = search.nodes;
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - search.start).count();
+    result.nodesPerSecond = result.seconds > 0 ? result.nodes / result.seconds : 0;
+    result.memoryBytes = search.table.memoryBytes();
+    return result;
+}
+
+/**
+ * @brief Chooses the computer's move for the EXPERT difficulty.
+ *
+ * @param game The current game state.
+ * @param computer The computer's player type (X or O).
+ * @return The move to play. Proven wins are played immediately; otherwise the classic board
+ *         falls back to minimax and larger boards to a line-scoring heuristic.
+ */
+pair<int, int> expertMove(Game game, PLAYER computer)
+{
+    SolveResult result;
+    {
+        TRACE_SPAN("solvePosition");
+        result = solvePosition(game, defaultSolverLimits(game));
+    }
+    countMetric(SOLVER_NODES, result.nodes);
+    if (logEngineStats)
+    {
+        cout << "Solver: " << result.nodes << " nodes in " << result.seconds * 1000 << " ms ("
+             << static_cast<uint64_t>(result.nodesPerSecond) << " nodes/sec, "
+             << result.memoryBytes / 1024 << " KiB table)" << endl;
+    }
+
+    if (result.value == PROVEN_WIN)
+        return result.move;
+
+    pair<int, int> move;
+    if (game.variant == CLASSIC)
+    {
+        TRACE_SPAN("minimax");
+        minimax(game, move, computer);
+        return move;
+    }
+    return heuristicMove(game);
+}
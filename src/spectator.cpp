@@ -0,0 +1,321 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This file implements spectator mode. The hub accepts observers on SPECTATOR_PORT from a background
+thread. broadcastGame() serializes the game once into a reference-counted buffer that every
+observer shares; nothing is copied per observer. Each observer holds at most two buffers: the one
+currently being written and the newest one waiting behind it. A slow observer therefore skips
+intermediate states (every snapshot is a full game) instead of growing an unbounded queue. On
+POSIX systems both buffers go out in a single writev call.
+*/
+
+#include "spectator.hpp"
+#include "graphics.hpp"
+#include "trace.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <csignal>
+#include <sys/uio.h>
+#define SPECTATOR_WRITEV 1
+#endif
+
+namespace
+{
+class SpectatorSocket : public TcpSocket
+{
+public:
+    using TcpSocket::getHandle; // native handle, needed for scatter/gather writes
+};
+
+struct Subscriber
+{
+    unique_ptr<SpectatorSocket> socket;
+    shared_ptr<const string> inFlight; // snapshot being written; never dropped once started
+    size_t offset = 0; // bytes of inFlight already written
+    shared_ptr<const string> pending; // newest snapshot behind inFlight; replaced, never queued
+    bool failed = false; // write error or disconnect, removed by the hub thread
+};
+
+/**
+ * @brief Marks `written` bytes of the subscriber's buffers as sent.
+ */
+void advance(Subscriber &subscriber, size_t written)
+{
+    size_t remaining = subscriber.inFlight->size() - subscriber.offset;
+    if (written < remaining)
+    {
+        subscriber.offset += written;
+        return;
+    }
+    subscriber.inFlight = move(subscriber.pending);
+    subscriber.pending.reset();
+    subscriber.offset = written - remaining;
+}
+
+/**
+ * @brief Writes as much of the subscriber's backlog as the socket accepts without blocking.
+ *
+ * @return False if the observer is gone and should be dropped.
+ */
+bool flush(Subscriber &subscriber)
+{
+    while (subscriber.inFlight)
+    {
+        size_t requested = subscriber.inFlight->size() - subscriber.offset;
+#ifdef SPECTATOR_WRITEV
+        iovec parts[2];
+        int count = 0;
+        parts[count].iov_base = const_cast<char *>(subscriber.inFlight->data()) + subscriber.offset;
+        parts[count++].iov_len = requested;
+        if (subscriber.pending)
+        {
+            parts[count].iov_base = const_cast<char *>(subscriber.pending->data());
+            parts[count++].iov_len = subscriber.pending->size();
+            requested += subscriber.pending->size();
+        }
+        ssize_t written = writev(subscriber.socket->getHandle(), parts, count);
+        if (written < 0)
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        advance(subscriber, static_cast<size_t>(written));
+        if (static_cast<size_t>(written) < requested)
+            return true; // socket buffer is full, the hub thread retries later
+#else
+        size_t sent = 0;
+        Socket::Status status = subscriber.socket->send(subscriber.inFlight->data() + subscriber.offset, requested, sent);
+        if (status == Socket::Disconnected || status == Socket::Error)
+            return false;
+        advance(subscriber, sent);
+        if (status != Socket::Done)
+            return true;
+#endif
+    }
+    return true;
+}
+
+class SpectatorHub
+{
+public:
+    ~SpectatorHub()
+    {
+        stopping = true;
+        if (worker.joinable())
+            worker.join();
+    }
+
+    /**
+     * @brief Starts listening for observers. Safe to call more than once.
+     */
+    bool start()
+    {
+        lock_guard<mutex> guard(lock);
+        if (running)
+            return true;
+        if (listener.listen(SPECTATOR_PORT) != Socket::Done)
+        {
+            cerr << "Spectator port " << SPECTATOR_PORT << " is in use, spectating disabled" << endl;
+            return false;
+        }
+#ifdef SPECTATOR_WRITEV
+        signal(SIGPIPE, SIG_IGN); // writev to a closed observer must fail with EPIPE, not kill the game
+#endif
+        selector.add(listener);
+        running = true;
+        worker = thread(&SpectatorHub::run, this);
+        return true;
+    }
+
+    /**
+     * @brief Hands the encoded snapshot to every observer and writes what fits right away.
+     */
+    void publish(const shared_ptr<const string> &frame)
+    {
+        lock_guard<mutex> guard(lock);
+        if (!running)
+            return;
+        latest = frame;
+        for (Subscriber &subscriber : subscribers)
+        {
+            if (subscriber.failed)
+                continue;
+            if (!subscriber.inFlight || subscriber.offset == 0)
+            {
+                subscriber.inFlight = frame; // nothing written yet, the old snapshot is stale
+                subscriber.pending.reset();
+            }
+            else
+            {
+                subscriber.pending = frame; // coalesce: drop whatever was waiting
+            }
+            subscriber.failed = !flush(subscriber);
+        }
+    }
+
+    size_t count()
+    {
+        lock_guard<mutex> guard(lock);
+        return subscribers.size();
+    }
+
+private:
+    /**
+     * @brief Hub thread: accepts observers, notices disconnects and retries stalled writes.
+     */
+    void run()
+    {
+        setTraceThreadName("spectator hub");
+        while (!stopping)
+        {
+            bool ready = selector.wait(milliseconds(20));
+            lock_guard<mutex> guard(lock);
+            if (ready && selector.isReady(listener))
+            {
+                Subscriber subscriber;
+                subscriber.socket.reset(new SpectatorSocket());
+                if (listener.accept(*subscriber.socket) == Socket::Done)
+                {
+                    subscriber.socket->setBlocking(false);
+                    subscriber.inFlight = latest; // new observers start from the current position
+                    selector.add(*subscriber.socket);
+                    subscribers.push_back(move(subscriber));
+                }
+            }
+            for (Subscriber &subscriber : subscribers)
+            {
+                if (ready && selector.isReady(*subscriber.socket))
+                {
+                    // Observers never send anything, so readable means disconnected
+                    char discard[64];
+                    size_t received;
+                    Socket::Status status = subscriber.socket->receive(discard, sizeof(discard), received);
+                    if (status == Socket::Disconnected || status == Socket::Error)
+                        subscriber.failed = true;
+                }
+                if (!subscriber.failed)
+                    subscriber.failed = !flush(subscriber);
+            }
+            for (size_t i = subscribers.size(); i-- > 0;)
+            {
+                if (subscribers[i].failed)
+                {
+                    selector.remove(*subscribers[i].socket);
+                    subscribers.erase(subscribers.begin() + i);
+                }
+            }
+        }
+    }
+
+    TcpListener listener;
+    SocketSelector selector; // only used by the hub thread once started
+    mutex lock; // guards subscribers and latest
+    vector<Subscriber> subscribers;
+    shared_ptr<const string> latest; // last published snapshot, sent to observers as they join
+    thread worker;
+    atomic<bool> stopping{false};
+    bool running = false;
+};
+
+SpectatorHub hub;
+}
+
+/**
+ * @brief Starts accepting spectators for games played by this process.
+ *
+ * @return False if the spectator port could not be opened; the game runs normally either way.
+ */
+bool startSpectatorHub()
+{
+    return hub.start();
+}
+
+/**
+ * @brief Sends the current game state to every spectator.
+ *
+ * The game is serialized once per call regardless of the number of spectators. Does nothing if
+ * the hub has not been started.
+ *
+ * @param game The game state to publish.
+ */
+void broadcastGame(const Game &game)
+{
+    TRACE_SPAN("broadcastGame");
+    string frame = game.serialize();
+    frame.push_back('\0'); // snapshots are null-terminated on the wire, like other game messages
+    hub.publish(make_shared<const string>(move(frame)));
+}
+
+/**
+ * @brief Returns the number of connected spectators.
+ */
+size_t spectatorCount()
+{
+    return hub.count();
+}
+
+/**
+ * @brief Connects to the game host as a spectator and draws each state it publishes until the
+ *        window is closed or the host goes away.
+ */
+void watchGame()
+{
+    TcpSocket spectatorSocket;
+    if (spectatorSocket.connect(SERVER_IP, SPECTATOR_PORT) != Socket::Done)
+    {
+        cerr << "No game to spectate at " << SERVER_IP << ":" << SPECTATOR_PORT << endl;
+        return;
+    }
+    spectatorSocket.setBlocking(false);
+    cout << "Spectating game at " << SERVER_IP << endl;
+
+    initStatusBar();
+    Game game;
+    string buffered;
+
+    while (window.isOpen())
+    {
+        Event event;
+        while (window.pollEvent(event))
+        {
+            if (event.type == Event::Closed)
+            {
+                window.close();
+                return;
+            }
+        }
+
+        char chunk[4096];
+        size_t received = 0;
+        Socket::Status status = spectatorSocket.receive(chunk, sizeof(chunk), received);
+        if (status == Socket::Disconnected || status == Socket::Error)
+        {
+            cout << "Game host disconnected" << endl;
+            return;
+        }
+        buffered.append(chunk, received);
+
+        // Only the newest complete snapshot matters
+        size_t last = buffered.rfind('\0');
+        if (last == string::npos)
+        {
+            sleep(milliseconds(15));
+            continue;
+        }
+        size_t first = buffered.rfind('\0', last == 0 ? 0 : last - 1);
+        first = (first == string::npos || first == last) ? 0 : first + 1;
+        game.deserialize(buffered.substr(first, last - first));
+        buffered.erase(0, last + 1);
+
+        game.mode = SPECTATOR;
+        drawGame(game);
+        if (game.status != PLAYING)
+        {
+            gameOverScreen(game.status, NONE);
+        }
+    }
+}
@@ -0,0 +1,448 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This file implements the engine strength ladder. On the classic and Gomoku boards a level runs
+an iterative-deepening alpha-beta search up to its depth, stopping early when its node budget is
+spent, and then picks a root move by softmax over the move values (plus Gaussian noise), so weak
+levels still prefer good moves without always finding them. Leaves are scored by the pattern
+evaluator, which the board keeps up to date on every move, so a node costs a handful of line
+updates rather than a scan of the board. Ultimate and Qubic map the level onto their own engines'
+budgets.
+*/
+
+#include "strength.hpp"
+#include "metrics.hpp"
+#include "qubic.hpp"
+#include "ultimate.hpp"
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+
+namespace
+{
+const int WIN_SCORE = 1000000; // score of a win, reduced by the number of plies to reach it
+const int NEAR_RADIUS = 1; // on large boards only cells this close to a mark are searched
+
+const StrengthLevel LEVELS[STRENGTH_LEVELS] = {
+    {"random", 0, 0, 0, 0},
+    {"novice", 1, 100, 16, 8},
+    {"beginner", 1, 200, 8, 4},
+    {"casual", 2, 1000, 4, 2},
+    {"club", 2, 2000, 2, 1},
+    {"medium", 3, 5000, 1, 0.5},
+    {"strong", 4, 20000, 0.5, 0.25},
+    {"advanced", 5, 50000, 0.25, 0},
+    {"expert", 6, 200000, 0, 0},
+    {"master", 8, 500000, 0, 0},
+};
+
+/**
+ * @brief Board for the ladder search, with the pattern evaluator kept up to date on every move.
+ */
+class LadderBoard
+{
+public:
+    const LineTable &lines;
+    int cols;
+    vector<int8_t> cells; // 0 empty, 1 X, 2 O
+    vector<uint8_t> neighbors; // marks within NEAR_RADIUS of each cell
+    PatternEvaluator evaluator;
+    int toMove; // 0 for X, 1 for O
+    int filled = 0; // marks on the board
+    bool lastMoveWon = false;
+
+    LadderBoard(const Game &game, const EvalWeights &weights)
+        : lines(*game.lines), cols(game.cols), cells(game.rows * game.cols, 0), neighbors(cells.size(), 0),
+          evaluator(lines, weights), toMove(game.activeTurn == X ? 0 : 1)
+    {
+        evaluator.setBoard(game.grid);
+        for (int cell = 0; cell < static_cast<int>(cells.size()); ++cell)
+        {
+            cells[cell] = static_cast<int8_t>(game.grid[cell / cols][cell % cols]);
+            if (cells[cell] != 0)
+            {
+                filled++;
+                updateNeighbors(cell, 1);
+            }
+        }
+    }
+
+    void play(int cell)
+    {
+        cells[cell] = static_cast<int8_t>(toMove + 1);
+        filled++;
+        evaluator.play(cell, toMove);
+        lastMoveWon = evaluator.hasWon(toMove);
+        updateNeighbors(cell, 1);
+        toMove ^= 1;
+    }
+
+    void undo(int cell)
+    {
+        toMove ^= 1;
+        updateNeighbors(cell, -1);
+        evaluator.undo(cell, toMove);
+        cells[cell] = 0;
+        filled--;
+        lastMoveWon = false;
+    }
+
+    /**
+     * @brief Returns the static evaluation from the point of view of the player to move.
+     */
+    int evaluate() const { return evaluator.evaluate(toMove); }
+
+    /**
+     * @brief Lists the cells worth searching: every empty cell on small boards, and the empty
+     *        cells next to a mark on large ones.
+     */
+    int candidates(vector<int> &moves) const
+    {
+        moves.clear();
+        bool nearOnly = cells.size() > 16;
+        if (nearOnly && filled == 0)
+        {
+            moves.push_back(static_cast<int>(cells.size()) / 2); // open in the center
+            return 1;
+        }
+        for (int cell = 0; cell < static_cast<int>(cells.size()); ++cell)
+        {
+            if (cells[cell] == 0 && (!nearOnly || neighbors[cell] > 0))
+                moves.push_back(cell);
+        }
+        return static_cast<int>(moves.size());
+    }
+
+    int size() const { return static_cast<int>(cells.size()); }
+
+private:
+    void updateNeighbors(int cell, int delta)
+    {
+        int rows = size() / cols, row = cell / cols, col = cell % cols;
+        for (int r = max(0, row - NEAR_RADIUS); r <= min(rows - 1, row + NEAR_RADIUS); ++r)
+        {
+            for (int c = max(0, col - NEAR_RADIUS); c <= min(cols - 1, col + NEAR_RADIUS); ++c)
+                neighbors[r * cols + c] += delta;
+        }
+    }
+};
+
+class LadderSearch
+{
+public:
+    LadderSearch(LadderBoard &board, uint64_t nodeBudget) : board(board), nodeBudget(nodeBudget) {}
+
+    uint64_t nodes = 0;
+    bool aborted = false;
+    bool enforceBudget = false; // the first iteration always completes so there is a move to play
+    uint64_t deadline = 0; // metricsClockMicros() time at which to stop, 0 for none
+    const atomic<bool> *stop = nullptr; // set from another thread to stop
+
+    int search(int depth, int alpha, int beta, int ply)
+    {
+        nodes++;
+        if (enforceBudget && (nodes >= nodeBudget || ((nodes & 1023) == 0 && timeUp())))
+            aborted = true;
+        if (aborted)
+            return 0;
+
+        if (board.lastMoveWon)
+            return -(WIN_SCORE - ply); // the player who just moved completed a line
+        if (board.filled == board.size())
+            return 0;
+        if (depth == 0)
+            return board.evaluate();
+
+        vector<int> moves;
+        board.candidates(moves);
+        if (depth > 1)
+            orderMoves(moves);
+        int best = -WIN_SCORE - 1;
+        for (int cell : moves)
+        {
+            board.play(cell);
+            int score = -search(depth - 1, -beta, -alpha, ply + 1);
+            board.undo(cell);
+            if (aborted)
+                return 0;
+            best = max(best, score);
+            alpha = max(alpha, score);
+            if (alpha >= beta)
+                break;
+        }
+        return best;
+    }
+
+private:
+    LadderBoard &board;
+    uint64_t nodeBudget;
+
+    bool timeUp() const
+    {
+        return (deadline != 0 && metricsClockMicros() >= deadline) || (stop && stop->load(memory_order_relaxed));
+    }
+
+    /**
+     * @brief Sorts moves by the static evaluation they lead to, best first for the player to move.
+     */
+    void orderMoves(vector<int> &moves)
+    {
+        vector<pair<int, int>> scored;
+        scored.reserve(moves.size());
+        for (int cell : moves)
+        {
+            board.play(cell);
+            int score = board.lastMoveWon ? WIN_SCORE : -board.evaluate();
+            board.undo(cell);
+            scored.push_back({-score, cell});
+        }
+        sort(scored.begin(), scored.end());
+        for (size_t i = 0; i < moves.size(); ++i)
+            moves[i] = scored[i].second;
+    }
+};
+
+/**
+ * @brief Picks a root move: softmax over the noisy values, or the best value at zero temperature.
+ */
+int pickMove(const vector<int> &moves, const vector<int> &values, const StrengthLevel &level, mt19937 &generator)
+{
+    normal_distribution<double> noise(0.0, level.noise > 0 ? level.noise : 1.0);
+    vector<double> noisy(values.begin(), values.end());
+    if (level.noise > 0)
+    {
+        for (double &value : noisy)
+            value += noise(generator);
+    }
+
+    double best = *max_element(noisy.begin(), noisy.end());
+    vector<double> weights(noisy.size());
+    for (size_t i = 0; i < noisy.size(); ++i)
+    {
+        if (level.temperature > 0)
+            weights[i] = exp((noisy[i] - best) / level.temperature);
+        else
+            weights[i] = noisy[i] == best ? 1.0 : 0.0; // ties are broken at random
+    }
+    discrete_distribution<size_t> choice(weights.begin(), weights.end());
+    return moves[choice(generator)];
+}
+
+/**
+ * @brief Runs the ladder search on the classic or Gomoku board.
+ */
+pair<int, int> lineBoardMove(const Game &game, const StrengthLevel &level, const EvalWeights &weights, mt19937 &generator)
+{
+    LadderBoard board(game, weights);
+    LadderSearch search(board, level.nodeBudget);
+
+    vector<int> moves;
+    board.candidates(moves);
+    vector<int> values(moves.size(), 0), iteration(moves.size());
+
+    for (int depth = 1; depth <= level.depth; ++depth)
+    {
+        search.enforceBudget = depth > 1;
+        for (size_t i = 0; i < moves.size() && !search.aborted; ++i)
+        {
+            board.play(moves[i]);
+            iteration[i] = -search.search(depth - 1, -WIN_SCORE - 1, WIN_SCORE + 1, 1);
+            board.undo(moves[i]);
+        }
+        if (search.aborted)
+            break; // keep the values of the deepest completed iteration
+        values = iteration;
+    }
+    countMetric(LADDER_NODES, search.nodes);
+
+    int cell = pickMove(moves, values, level, generator);
+    return {cell / game.cols, cell % game.cols};
+}
+
+/**
+ * @brief Searches the classic or Gomoku board at full strength within the analysis limits.
+ *
+ * Root moves are searched best-first from the previous iteration, with a shrinking window, so only
+ * the best move's value is exact.
+ */
+AnalysisResult analyzeLineBoard(const Game &game, const AnalysisLimits &limits, const EvalWeights &weights)
+{
+    AnalysisResult result;
+    LadderBoard board(game, weights);
+    LadderSearch search(board, limits.maxNodes);
+    search.stop = limits.stop;
+    if (limits.maxSeconds > 0)
+        search.deadline = metricsClockMicros() + static_cast<uint64_t>(limits.maxSeconds * 1e6);
+
+    vector<int> moves;
+    board.candidates(moves);
+    vector<pair<int, int>> ranked; // {-value, cell} from the last completed iteration, best first
+    for (int cell : moves)
+        ranked.push_back({0, cell});
+
+    for (int depth = 1; depth <= limits.maxDepth; ++depth)
+    {
+        search.enforceBudget = depth > 1;
+        vector<pair<int, int>> iteration;
+        int alpha = -WIN_SCORE - 1;
+        for (const pair<int, int> &entry : ranked)
+        {
+            board.play(entry.second);
+            int score = -search.search(depth - 1, -WIN_SCORE - 1, -alpha, 1);
+            board.undo(entry.second);
+            if (search.aborted)
+                break;
+            iteration.push_back({-score, entry.second});
+            alpha = max(alpha, score);
+        }
+        if (search.aborted)
+            break; // keep the deepest completed iteration
+
+        stable_sort(iteration.begin(), iteration.end());
+        ranked = iteration;
+        result.move = {ranked[0].second / game.cols, ranked[0].second % game.cols};
+        result.score = -ranked[0].first;
+        result.depth = depth;
+        if (abs(result.score) > WIN_SCORE - 1000 || depth >= board.size() - board.filled)
+            break; // decided, or every remaining cell is already searched
+    }
+    if (result.score > WIN_SCORE - 1000)
+        result.winIn = WIN_SCORE - result.score;
+    else if (result.score < -(WIN_SCORE - 1000))
+        result.winIn = -(WIN_SCORE + result.score);
+    result.nodes = search.nodes;
+    countMetric(LADDER_NODES, search.nodes);
+    return result;
+}
+}
+
+/**
+ * @brief Returns the settings of a ladder level (clamped to the valid range).
+ */
+const StrengthLevel &strengthLevel(int level)
+{
+    return LEVELS[min(max(level, 0), STRENGTH_LEVELS - 1)];
+}
+
+/**
+ * @brief Picks a uniformly random legal move in constant time from the legal-move bitmask.
+ *
+ * @param game The current game state. It must still be in play.
+ * @param generator The random number generator to draw from.
+ * @return The row and column of the chosen cell.
+ */
+pair<int, int> randomMoveFromMask(const Game &game, mt19937 &generator)
+{
+    uint64_t mask[BOARD_MASK_WORDS];
+    int count = game.legalMoveMask(mask);
+    int pick = static_cast<int>(generator() % count);
+
+    for (int word = 0; word < BOARD_MASK_WORDS; ++word)
+    {
+        int bits = static_cast<int>(bitset<64>(mask[word]).count());
+        if (pick >= bits)
+        {
+            pick -= bits;
+            continue;
+        }
+        uint64_t remaining = mask[word];
+        for (; pick > 0; --pick)
+            remaining &= remaining - 1; // drop the lowest set bit
+        int index = word * 64 + static_cast<int>(bitset<64>((remaining & (~remaining + 1)) - 1).count());
+        return {index / game.cols, index % game.cols};
+    }
+    return {-1, -1}; // unreachable while the game is in play
+}
+
+/**
+ * @brief Chooses a move at a given ladder level.
+ *
+ * @param game The current game state. It must still be in play.
+ * @param level The ladder level, from 0 (random) to STRENGTH_LEVELS - 1.
+ * @param weights The pattern evaluator weights used on the classic and Gomoku boards.
+ * @return The row and column of the chosen move.
+ */
+pair<int, int> strengthMove(const Game &game, int level, const EvalWeights &weights)
+{
+    thread_local mt19937 generator(random_device{}());
+    const StrengthLevel &settings = strengthLevel(level);
+    if (settings.depth == 0)
+    {
+        return randomMoveFromMask(game, generator);
+    }
+
+    if (game.variant == ULTIMATE) // the node budget becomes the playout budget
+    {
+        MctsLimits limits;
+        limits.maxPlayouts = settings.nodeBudget / 10 + 1;
+        limits.maxSeconds = 5.0;
+        return ultimateMove(game, limits);
+    }
+    if (game.variant == QUBIC) // depth and node budget carry over to the Qubic search
+    {
+        QubicLimits limits;
+        limits.maxDepth = settings.depth;
+        limits.maxNodes = settings.nodeBudget;
+        limits.maxSeconds = 5.0;
+        return qubicMove(game, limits);
+    }
+    return lineBoardMove(game, settings, weights, generator);
+}
+
+/**
+ * @brief Searches a position at full strength for analysis, as the headless engine does.
+ *
+ * @param game The position to analyze.
+ * @param limits Depth, node and time budgets, and a flag that stops the search from another thread.
+ * @param weights The pattern evaluator weights used on the classic and Gomoku boards.
+ * @return The best move with its score and search statistics; the move is {-1, -1} if the game is over.
+ */
+AnalysisResult analyzePosition(const Game &game, const AnalysisLimits &limits, const EvalWeights &weights)
+{
+    AnalysisResult result;
+    if (game.status != PLAYING)
+    {
+        return result;
+    }
+    uint64_t startedAt = metricsClockMicros();
+
+    if (game.variant == ULTIMATE)
+    {
+        MctsLimits mcts;
+        if (limits.maxNodes != UINT64_MAX)
+            mcts.maxPlayouts = limits.maxNodes;
+        mcts.maxSeconds = limits.maxSeconds > 0 ? limits.maxSeconds : 1.0;
+        mcts.stop = limits.stop;
+        MctsResult search = searchUltimate(UltimateBoard::fromGame(game), mcts);
+        countMetric(MCTS_PLAYOUTS, search.playouts);
+        result.move = ultimateMoveCell(search.move);
+        result.score = static_cast<int>(lround(search.winRate * 1000));
+        result.nodes = search.playouts;
+    }
+    else if (game.variant == QUBIC)
+    {
+        QubicLimits qubic;
+        qubic.maxDepth = limits.maxDepth;
+        qubic.maxNodes = limits.maxNodes;
+        qubic.maxSeconds = limits.maxSeconds > 0 ? limits.maxSeconds : 1e9;
+        qubic.stop = limits.stop;
+        QubicResult search = searchQubic(QubicBoard::fromGame(game), qubic);
+        countMetric(QUBIC_NODES, search.nodes);
+        result.move = qubicCellPosition(search.cell);
+        result.score = search.score;
+        result.depth = search.depth;
+        result.nodes = search.nodes;
+        if (search.score > QUBIC_WIN_SCORE - 1000)
+            result.winIn = QUBIC_WIN_SCORE - search.score;
+        else if (search.score < -(QUBIC_WIN_SCORE - 1000))
+            result.winIn = -(QUBIC_WIN_SCORE + search.score);
+    }
+    else
+    {
+        result = analyzeLineBoard(game, limits, weights);
+    }
+    result.seconds = (metricsClockMicros() - startedAt) / 1e6;
+    return result;
+}
@@ -0,0 +1,119 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This is the entry point of the `tictactoe-batchcheck` tool. It checks that every path of the batch
+win detector (AVX2, SSE2 and scalar, each forced in turn) gives exactly the status
+Game::updateGameStatus gives, for all 3^9 fillings of the classic board, including the ones that
+cannot come up in a real game. The boards are classified from several unaligned array offsets and
+in runs of varying length, so the vector loops and their scalar tails are both covered, and a
+guard byte after each run catches writes past the end. A path the CPU cannot run is skipped. The
+tool exits with status 1 on any mismatch, so it can gate changes to batch.cpp.
+
+Usage: tictactoe-batchcheck
+*/
+
+#include "batch.hpp"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+using namespace std;
+
+const int BOARDS = 19683; // 3^9
+const size_t OFFSETS[] = {0, 1, 2, 3, 5, 7, 8, 15, 16, 17}; // elements before the first board
+const size_t MAX_RUN = 37; // runs cycle through 1..MAX_RUN boards
+const uint8_t GUARD = 0xA5;
+
+/**
+ * @brief Builds every filling of the classic board and its status according to updateGameStatus.
+ */
+void buildBoards(vector<uint16_t> &xMasks, vector<uint16_t> &oMasks, vector<uint8_t> &expected)
+{
+    Game game(SINGLE_PLAYER, DEFAULT, CLASSIC);
+    for (int index = 0; index < BOARDS; ++index)
+    {
+        int digits = index;
+        for (int cell = 0; cell < 9; ++cell, digits /= 3)
+            game.grid[cell / 3][cell % 3] = digits % 3;
+        game.updateGameStatus();
+
+        uint16_t x, o;
+        packBoard(game, x, o);
+        xMasks.push_back(x);
+        oMasks.push_back(o);
+        expected.push_back(static_cast<uint8_t>(game.status));
+    }
+}
+
+/**
+ * @brief Checks one classifier path against the expected statuses.
+ * @return The number of mismatches, or -1 if the CPU cannot run the path.
+ */
+int checkPath(const string &name, const vector<uint16_t> &xMasks, const vector<uint16_t> &oMasks, const vector<uint8_t> &expected)
+{
+    int mismatches = 0;
+    for (size_t offset : OFFSETS)
+    {
+        // Copy the boards behind `offset` filler elements so the loads start unaligned
+        vector<uint16_t> x(offset, 0), o(offset, 0);
+        x.insert(x.end(), xMasks.begin(), xMasks.end());
+        o.insert(o.end(), oMasks.begin(), oMasks.end());
+        vector<uint8_t> results(offset + BOARDS + 1, GUARD);
+
+        // The whole array in one call, then in short runs that end in every possible tail
+        vector<pair<size_t, size_t>> runs = {{0, BOARDS}};
+        for (size_t start = 0, length = 1; start < BOARDS; start += length, length = length % MAX_RUN + 1)
+            runs.push_back({start, min<size_t>(length, BOARDS - start)});
+
+        for (const pair<size_t, size_t> &run : runs)
+        {
+            size_t start = offset + run.first, count = run.second;
+            results[start + count] = GUARD;
+            if (!classifyBoardsWith(name, x.data() + start, o.data() + start, results.data() + start, count))
+                return -1;
+            if (results[start + count] != GUARD)
+            {
+                cerr << name << ": wrote past the end of a run of " << count << " boards at offset " << offset << endl;
+                mismatches++;
+            }
+            for (size_t i = run.first; i < run.first + count; ++i)
+            {
+                if (results[offset + i] != expected[i] && mismatches++ < 10)
+                {
+                    cerr << name << ": X " << xMasks[i] << " O " << oMasks[i] << " gives " << int(results[offset + i])
+                         << ", updateGameStatus gives " << int(expected[i]) << " (offset " << offset << ", run of "
+                         << count << ")" << endl;
+                }
+            }
+        }
+    }
+    return mismatches;
+}
+
+int main()
+{
+    vector<uint16_t> xMasks, oMasks;
+    vector<uint8_t> expected;
+    buildBoards(xMasks, oMasks, expected);
+
+    bool passed = true;
+    for (const char *name : BATCH_CLASSIFIERS)
+    {
+        int mismatches = checkPath(name, xMasks, oMasks, expected);
+        if (mismatches < 0)
+            cout << name << ": skipped (not supported by this CPU)" << endl;
+        else if (mismatches == 0)
+            cout << name << ": " << BOARDS << " boards at " << size(OFFSETS) << " offsets agree" << endl;
+        else
+        {
+            cout << name << ": " << mismatches << " mismatches" << endl;
+            passed = false;
+        }
+    }
+    cout << "Dispatched path: " << batchClassifierName() << endl;
+    cout << (passed ? "PASS" : "FAIL") << endl;
+    return passed ? 0 : 1;
+}
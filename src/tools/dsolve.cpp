@@ -0,0 +1,474 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This is the entry point of the `tictactoe-dsolve` tool, which solves an m,n,k game (k in a row on
+an m x n board) across several worker processes. The coordinator splits the position into the
+symmetry-distinct positions a few moves deep, hands them out one at a time to workers connected
+over a Unix domain socket, and combines the values they report into the value of the position and
+of every first move. Each solved partition is appended to a checkpoint file, so a run that is
+interrupted resumes where it stopped. A worker that dies has its partition handed to another and
+is replaced; more workers can join from other shells with --worker.
+
+Usage: tictactoe-dsolve [options]
+  --rows M, --cols N   board size (default 4 x 4)
+  --length K           marks in a row needed to win (default 4)
+  --position CELLS     position to solve, one x, o or . per cell row by row (default: empty board)
+  --plies P            moves deep to split the position (default 2)
+  --workers W          worker processes to start (default: all cores; 0 waits for outside workers)
+  --table MB           transposition table of each worker (default 256)
+  --checkpoint FILE    solved partitions, read on start and appended to (default dsolve.checkpoint)
+  --socket PATH        socket the workers connect to (default /tmp/tictactoe-dsolve-<pid>.sock)
+       tictactoe-dsolve --worker PATH [--table MB]
+                       runs a worker for the coordinator listening on PATH
+*/
+
+#include "mnk.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <poll.h>
+#include <set>
+#include <sstream>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+
+const int RESPAWNS_PER_WORKER = 3; // replacements started for each worker before the coordinator gives up
+const int CONNECT_ATTEMPTS = 50; // tries a worker makes, 100 ms apart, while the coordinator starts
+
+struct Options
+{
+    int rows = 4;
+    int cols = 4;
+    int length = 4;
+    string position;
+    int plies = 2;
+    int workers = max(1u, thread::hardware_concurrency());
+    size_t tableMegabytes = 256;
+    string checkpoint = "dsolve.checkpoint";
+    string socketPath = "/tmp/tictactoe-dsolve-" + to_string(getpid()) + ".sock";
+    bool worker = false;
+};
+
+/**
+ * @brief Newline-delimited messages over a stream socket.
+ */
+class LineConnection
+{
+public:
+    explicit LineConnection(int fd) : fd(fd) {}
+    ~LineConnection() { close(fd); }
+
+    int descriptor() const { return fd; }
+
+    bool sendLine(const string &line)
+    {
+        string data = line + "\n";
+        for (size_t sent = 0; sent < data.size();)
+        {
+            ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0)
+                return false;
+            sent += n;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Reads what has arrived and appends the complete lines to `lines`.
+     *
+     * @param block Wait for data instead of returning when none is ready.
+     * @return False once the peer has closed the connection.
+     */
+    bool receiveLines(vector<string> &lines, bool block)
+    {
+        char chunk[4096];
+        ssize_t n = recv(fd, chunk, sizeof(chunk), block ? 0 : MSG_DONTWAIT);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+            return false;
+        if (n > 0)
+            buffer.append(chunk, n);
+        for (size_t end; (end = buffer.find('\n')) != string::npos;)
+        {
+            lines.push_back(buffer.substr(0, end));
+            buffer.erase(0, end + 1);
+        }
+        return true;
+    }
+
+private:
+    int fd;
+    string buffer; // received bytes not yet ending in a newline
+};
+
+string valueName(int value)
+{
+    return value > 0 ? "win" : value < 0 ? "loss" : "draw";
+}
+
+/**
+ * @brief Solves the partitions the coordinator sends until told to quit.
+ */
+int runWorker(const Options &options)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, options.socketPath.c_str(), sizeof(address.sun_path) - 1);
+    int attempt = 0;
+    while (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+    {
+        if (++attempt == CONNECT_ATTEMPTS)
+        {
+            cerr << "Cannot connect to " << options.socketPath << ": " << strerror(errno) << endl;
+            close(fd);
+            return 1;
+        }
+        this_thread::sleep_for(chrono::milliseconds(100));
+    }
+
+    LineConnection coordinator(fd);
+    coordinator.sendLine("hello " + to_string(getpid()));
+    MnkTable table(options.tableMegabytes); // kept across partitions, which share many positions
+    vector<string> lines;
+    while (coordinator.receiveLines(lines, true))
+    {
+        for (const string &line : lines)
+        {
+            istringstream iss(line);
+            string command, cells;
+            int rows, cols, length;
+            iss >> command;
+            if (command == "quit")
+                return 0;
+            if (command != "solve" || !(iss >> rows >> cols >> length >> cells))
+                continue;
+
+            MnkBoard board(rows, cols, length);
+            if (!board.setCells(cells))
+            {
+                coordinator.sendLine("invalid " + cells);
+                continue;
+            }
+            MnkSolveResult result = solveMnk(board, table);
+            ostringstream reply;
+            reply << "value " << cells << " " << result.value << " " << result.nodes << " "
+                  << static_cast<uint64_t>(result.seconds * 1000);
+            if (!coordinator.sendLine(reply.str()))
+                return 1;
+        }
+        lines.clear();
+    }
+    return 1; // the coordinator went away
+}
+
+/**
+ * @brief Reads the solved partitions of an earlier run of the same problem.
+ *
+ * @param partitions The partitions of this problem; lines naming anything else are ignored.
+ * @return False if the file belongs to a different problem.
+ */
+bool loadCheckpoint(const string &path, const string &header, const vector<string> &partitions, map<string, int> &values)
+{
+    set<string> known(partitions.begin(), partitions.end());
+    ifstream file(path);
+    if (!file)
+        return true; // nothing solved yet
+    string line;
+    if (!getline(file, line) || line != header)
+    {
+        cerr << path << " is a checkpoint of another problem (" << line << ")" << endl;
+        return false;
+    }
+    while (getline(file, line))
+    {
+        istringstream iss(line);
+        string cells;
+        int value;
+        // A line torn by a crash either fails to parse or names no partition, and is solved again
+        if (iss >> cells >> value && known.count(cells) && value >= -1 && value <= 1)
+            values[cells] = value;
+    }
+    return true;
+}
+
+struct WorkerSlot
+{
+    unique_ptr<LineConnection> connection;
+    string assigned; // partition being solved, empty while idle
+    int pid = 0; // process id the worker reported
+    bool lost = false; // the connection closed
+};
+
+/**
+ * @brief Starts a worker process running this program with --worker.
+ */
+pid_t spawnWorker(const Options &options, const char *program)
+{
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        prctl(PR_SET_PDEATHSIG, SIGTERM); // do not outlive the coordinator
+        string table = to_string(options.tableMegabytes);
+        execl(program, program, "--worker", options.socketPath.c_str(), "--table", table.c_str(), nullptr);
+        _exit(127);
+    }
+    return pid;
+}
+
+int runCoordinator(const Options &options, const char *program)
+{
+    MnkBoard root(options.rows, options.cols, options.length);
+    if (!options.position.empty() && !root.setCells(options.position))
+    {
+        cerr << "Position does not fit a " << options.rows << "x" << options.cols << " board with X to move first" << endl;
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    vector<string> partitions = openingPartitions(root, options.plies);
+    string header = "dsolve " + to_string(options.rows) + " " + to_string(options.cols) + " " +
+                    to_string(options.length) + " " + to_string(options.plies) + " " + root.text();
+    map<string, int> values;
+    if (!loadCheckpoint(options.checkpoint, header, partitions, values))
+        return 1;
+    deque<string> pending;
+    for (const string &partition : partitions)
+    {
+        if (!values.count(partition))
+            pending.push_back(partition);
+    }
+    cout << options.rows << "x" << options.cols << " board, " << options.length << " in a row: "
+         << partitions.size() << " partitions " << options.plies << " plies deep, "
+         << partitions.size() - pending.size() << " already solved in " << options.checkpoint << endl;
+
+    // Finish a line torn by a crash, so the next entry starts on a line of its own
+    ifstream existing(options.checkpoint, ios::binary);
+    bool fresh = !existing;
+    bool torn = !fresh && existing.seekg(-1, ios::end) && existing.peek() != '\n';
+    existing.close();
+    ofstream checkpoint(options.checkpoint, ios::app);
+    if (fresh)
+        checkpoint << header << endl;
+    else if (torn)
+        checkpoint << endl;
+
+    uint64_t nodes = 0, workerMillis = 0;
+    if (!pending.empty())
+    {
+        int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, options.socketPath.c_str(), sizeof(address.sun_path) - 1);
+        unlink(options.socketPath.c_str());
+        if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(listener, 64) != 0)
+        {
+            cerr << "Cannot listen on " << options.socketPath << ": " << strerror(errno) << endl;
+            return 1;
+        }
+        LineConnection listening(listener);
+
+        int spawned = 0, running = 0;
+        int spawnLimit = options.workers * (1 + RESPAWNS_PER_WORKER);
+        for (; spawned < options.workers; ++spawned)
+            running += spawnWorker(options, program) > 0;
+        cout << "Waiting for workers on " << options.socketPath << endl;
+
+        vector<WorkerSlot> workers;
+        size_t solvedBefore = values.size();
+        auto lastReport = chrono::steady_clock::now();
+        auto busy = [&workers] {
+            return any_of(workers.begin(), workers.end(), [](const WorkerSlot &slot) { return !slot.assigned.empty(); });
+        };
+        while (!pending.empty() || busy())
+        {
+            vector<pollfd> fds = {{listener, POLLIN, 0}};
+            for (const WorkerSlot &slot : workers)
+                fds.push_back({slot.connection->descriptor(), POLLIN, 0});
+            poll(fds.data(), fds.size(), 1000);
+
+            if (fds[0].revents & POLLIN)
+            {
+                int fd = accept(listener, nullptr, nullptr);
+                if (fd >= 0)
+                    workers.push_back({unique_ptr<LineConnection>(new LineConnection(fd)), "", 0, false});
+            }
+
+            for (size_t i = 0; i < workers.size(); ++i)
+            {
+                WorkerSlot &slot = workers[i];
+                vector<string> lines;
+                bool readable = i + 1 < fds.size() && fds[i + 1].revents; // workers accepted just now were not polled
+                slot.lost = readable && !slot.connection->receiveLines(lines, false);
+                for (const string &line : lines)
+                {
+                    istringstream iss(line);
+                    string command, cells;
+                    iss >> command;
+                    if (command == "hello")
+                    {
+                        iss >> slot.pid;
+                    }
+                    else if (command == "value" && iss >> cells && cells == slot.assigned)
+                    {
+                        int value;
+                        uint64_t partitionNodes = 0, millis = 0;
+                        iss >> value >> partitionNodes >> millis;
+                        values[cells] = value;
+                        nodes += partitionNodes;
+                        workerMillis += millis;
+                        checkpoint << cells << " " << value << " " << partitionNodes << endl;
+                        slot.assigned.clear();
+                    }
+                    else if (command == "invalid")
+                    {
+                        cerr << "Worker " << slot.pid << " rejected partition " << slot.assigned << endl;
+                        return 1;
+                    }
+                }
+
+                if (slot.lost)
+                {
+                    if (!slot.assigned.empty())
+                    {
+                        cout << "Worker " << slot.pid << " was lost; partition " << slot.assigned << " goes back in the queue" << endl;
+                        pending.push_front(slot.assigned);
+                    }
+                    else
+                    {
+                        cout << "Worker " << slot.pid << " was lost" << endl;
+                    }
+                    continue;
+                }
+                if (slot.assigned.empty() && slot.pid != 0 && !pending.empty())
+                {
+                    slot.assigned = pending.front();
+                    pending.pop_front();
+                    slot.connection->sendLine("solve " + to_string(options.rows) + " " + to_string(options.cols) + " " +
+                                              to_string(options.length) + " " + slot.assigned);
+                }
+            }
+
+            workers.erase(remove_if(workers.begin(), workers.end(), [](const WorkerSlot &slot) { return slot.lost; }),
+                          workers.end());
+
+            // Replace workers that died while partitions remain
+            for (int status; waitpid(-1, &status, WNOHANG) > 0;)
+                running--;
+            while (running < options.workers && spawned < spawnLimit && !pending.empty())
+            {
+                running += spawnWorker(options, program) > 0;
+                spawned++;
+            }
+            if (options.workers > 0 && running == 0 && workers.empty())
+            {
+                cerr << "No workers left; rerun the same command to resume from " << options.checkpoint << endl;
+                return 1;
+            }
+
+            auto now = chrono::steady_clock::now();
+            if (now - lastReport >= chrono::seconds(1))
+            {
+                lastReport = now;
+                double elapsed = chrono::duration<double>(now - start).count();
+                cout << "  " << values.size() << "/" << partitions.size() << " partitions solved, "
+                     << workers.size() << " workers, " << static_cast<uint64_t>(nodes / elapsed) << " nodes/sec" << endl;
+            }
+        }
+        for (WorkerSlot &slot : workers)
+            slot.connection->sendLine("quit");
+        workers.clear();
+        unlink(options.socketPath.c_str());
+        while (running > 0 && wait(nullptr) > 0)
+            running--;
+        cout << values.size() - solvedBefore << " partitions solved by workers" << endl;
+    }
+
+    vector<pair<int, int>> moveValues;
+    int value = combinePartitions(root, options.plies, values, options.plies > 0 ? &moveValues : nullptr);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Value for " << (root.toMove == 0 ? "X" : "O") << " to move: " << valueName(value) << endl;
+    if (!moveValues.empty())
+    {
+        // Value of each first move for the player making it: W win, D draw, L loss
+        vector<char> grid(root.cells.size(), '.');
+        for (const auto &move : moveValues)
+            grid[move.first] = move.second > 0 ? 'W' : move.second < 0 ? 'L' : 'D';
+        for (int row = 0; row < options.rows; ++row)
+            cout << "  " << string(grid.begin() + row * options.cols, grid.begin() + (row + 1) * options.cols) << endl;
+    }
+    cout << fixed << setprecision(2) << nodes << " nodes in " << seconds << " s wall, " << workerMillis / 1000.0
+         << " s in workers" << endl;
+    return 0;
+}
+
+bool parseOptions(int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--rows" && hasValue)
+            options.rows = atoi(argv[++i]);
+        else if (arg == "--cols" && hasValue)
+            options.cols = atoi(argv[++i]);
+        else if (arg == "--length" && hasValue)
+            options.length = atoi(argv[++i]);
+        else if (arg == "--position" && hasValue)
+            options.position = argv[++i];
+        else if (arg == "--plies" && hasValue)
+            options.plies = max(0, atoi(argv[++i]));
+        else if (arg == "--workers" && hasValue)
+            options.workers = max(0, atoi(argv[++i]));
+        else if (arg == "--table" && hasValue)
+            options.tableMegabytes = max(1, atoi(argv[++i]));
+        else if (arg == "--checkpoint" && hasValue)
+            options.checkpoint = argv[++i];
+        else if (arg == "--socket" && hasValue)
+            options.socketPath = argv[++i];
+        else if (arg == "--worker" && hasValue)
+        {
+            options.worker = true;
+            options.socketPath = argv[++i];
+        }
+        else
+        {
+            cerr << "Usage: tictactoe-dsolve [--rows M] [--cols N] [--length K] [--position CELLS] [--plies P]"
+                    " [--workers W] [--table MB] [--checkpoint FILE] [--socket PATH]\n"
+                    "       tictactoe-dsolve --worker PATH [--table MB]"
+                 << endl;
+            return false;
+        }
+    }
+    if (options.rows < 1 || options.cols < 1 || options.rows * options.cols > 256 || options.length < 2 ||
+        options.length > max(options.rows, options.cols))
+    {
+        cerr << "The board must have at most 256 cells and the line length must fit on it" << endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+    if (options.worker)
+        return runWorker(options);
+    return runCoordinator(options, "/proc/self/exe");
+}
@@ -0,0 +1,503 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This is the entry point of the `tictactoe-engine` tool, a headless engine that reads commands from
+standard input and answers on standard output, one line each, in the style of UCI. It is meant to
+stay running while an analysis pipeline streams positions through it: interactive searches run on
+a background thread so `stop` can end them, and batch queries are queued to a pool of searching
+threads so parsing, searching and printing overlap. The queue is bounded, so a fast producer is
+held back instead of buffering the whole input.
+
+Commands:
+  isready                       answers readyok
+  position VARIANT BOARD [moves R,C ...] [last R,C]
+                                sets the position; VARIANT is classic, gomoku, ultimate or qubic,
+                                BOARD is startpos or one character per cell (x, o or .) row by
+                                row, with optional '/' between rows; the side to move follows
+                                from the marks, and `last` gives the previous move in Ultimate;
+                                until a rejected position is replaced by a valid one, `go`
+                                answers `error no position` (before any `position`, the empty
+                                classic board is set)
+  go [depth N] [nodes N] [movetime MS] [infinite]
+                                searches the position (one second if no limit is given), printing
+                                `info depth D score S [win N|loss N] nodes N time MS nps N` and
+                                then `bestmove R,C` (or `bestmove none` if the game is over)
+  stop                          ends the running search, which still prints its result; other
+                                commands that need the search wait for it to finish instead
+  batch ID VARIANT BOARD [moves R,C ...] [last R,C] [depth N] [nodes N] [movetime MS]
+                                queues a position; the answer, in completion order, is
+                                `result ID bestmove R,C score S [win N|loss N] depth D nodes N time MS`
+  sync                          waits for every queued batch position, then answers syncok
+  setoption threads N           searching threads for batch positions (default: all cores)
+  quit                          stops the search and exits; end of input finishes the batch first
+Malformed commands are answered with `error MESSAGE` (`error ID MESSAGE` for batch positions).
+*/
+
+#include "strength.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+const size_t QUEUE_PER_THREAD = 4; // batch positions waiting per searching thread before input is held back
+
+/**
+ * @brief Writes whole lines to standard output from any thread, flushing each one.
+ */
+class Printer
+{
+public:
+    void line(const string &text)
+    {
+        lock_guard<mutex> guard(lock);
+        cout << text << endl;
+    }
+
+private:
+    mutex lock;
+};
+
+Printer printer;
+
+string formatMove(pair<int, int> move)
+{
+    return move.first < 0 ? "none" : to_string(move.first) + "," + to_string(move.second);
+}
+
+/**
+ * @brief Formats a forced result found by the search, or nothing if there is none.
+ */
+string formatWin(const AnalysisResult &result)
+{
+    if (result.winIn > 0)
+        return " win " + to_string(result.winIn);
+    if (result.winIn < 0)
+        return " loss " + to_string(-result.winIn);
+    return "";
+}
+
+struct Job
+{
+    string id; // label echoed in the result
+    Game game;
+    AnalysisLimits limits;
+};
+
+/**
+ * @brief Threads searching batch positions from a bounded queue, printing each result as it finishes.
+ */
+class SearchPool
+{
+public:
+    explicit SearchPool(int threads) : capacity(QUEUE_PER_THREAD * threads)
+    {
+        for (int i = 0; i < threads; ++i)
+            workers.emplace_back(&SearchPool::run, this);
+    }
+
+    ~SearchPool()
+    {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        jobReady.notify_all();
+        for (thread &worker : workers)
+            worker.join();
+    }
+
+    /**
+     * @brief Queues a position, waiting while the queue is full.
+     */
+    void submit(Job job)
+    {
+        unique_lock<mutex> guard(lock);
+        roomReady.wait(guard, [this] { return queue.size() < capacity; });
+        job.limits.stop = &cancelled;
+        queue.push_back(move(job));
+        jobReady.notify_one();
+    }
+
+    /**
+     * @brief Drops the queued positions and cuts the running searches short.
+     */
+    void cancel()
+    {
+        lock_guard<mutex> guard(lock);
+        queue.clear();
+        cancelled = true;
+        roomReady.notify_all();
+    }
+
+    /**
+     * @brief Waits until every queued position has been searched and printed.
+     */
+    void drain()
+    {
+        unique_lock<mutex> guard(lock);
+        idle.wait(guard, [this] { return queue.empty() && running == 0; });
+    }
+
+private:
+    size_t capacity;
+    vector<thread> workers;
+    mutex lock;
+    condition_variable jobReady; // signalled when a job is queued or the pool stops
+    condition_variable roomReady; // signalled when a job leaves the queue
+    condition_variable idle; // signalled when a job finishes
+    deque<Job> queue;
+    int running = 0;
+    bool stopping = false;
+    atomic<bool> cancelled{false}; // ends the searches in progress
+
+    void run()
+    {
+        while (true)
+        {
+            Job job;
+            {
+                unique_lock<mutex> guard(lock);
+                jobReady.wait(guard, [this] { return stopping || !queue.empty(); });
+                if (queue.empty())
+                    return; // stopping with nothing left to search
+                job = move(queue.front());
+                queue.pop_front();
+                running++;
+            }
+            roomReady.notify_one();
+
+            AnalysisResult result = analyzePosition(job.game, job.limits);
+            printer.line("result " + job.id + " bestmove " + formatMove(result.move) + " score " +
+                         to_string(result.score) + formatWin(result) + " depth " + to_string(result.depth) +
+                         " nodes " + to_string(result.nodes) + " time " +
+                         to_string(static_cast<uint64_t>(result.seconds * 1000)));
+
+            lock_guard<mutex> guard(lock);
+            running--;
+            idle.notify_all();
+        }
+    }
+};
+
+bool parseMove(const string &text, pair<int, int> &move)
+{
+    size_t comma = text.find(',');
+    if (comma == string::npos || comma == 0 || comma + 1 == text.size())
+        return false;
+    try
+    {
+        size_t used;
+        move.first = stoi(text.substr(0, comma), &used);
+        if (used != comma)
+            return false;
+        move.second = stoi(text.substr(comma + 1), &used);
+        return used == text.size() - comma - 1;
+    }
+    catch (const exception &)
+    {
+        return false;
+    }
+}
+
+bool parseCount(const string &text, uint64_t &value)
+{
+    if (text.empty() || text.size() > 18 || text.find_first_not_of("0123456789") != string::npos)
+        return false;
+    value = stoull(text);
+    return true;
+}
+
+/**
+ * @brief Reads `VARIANT BOARD [moves R,C ...] [last R,C]` starting at tokens[i].
+ *
+ * @param i Advanced past the tokens that were read.
+ * @param error Set to the reason when the position is rejected.
+ * @return True if the position is valid.
+ */
+bool parsePosition(const vector<string> &tokens, size_t &i, Game &game, string &error)
+{
+    if (i + 2 > tokens.size())
+    {
+        error = "position needs a variant and a board";
+        return false;
+    }
+    const string &name = tokens[i++];
+    VARIANT variant;
+    if (name == "classic") variant = CLASSIC;
+    else if (name == "gomoku") variant = GOMOKU;
+    else if (name == "ultimate") variant = ULTIMATE;
+    else if (name == "qubic") variant = QUBIC;
+    else
+    {
+        error = "unknown variant " + name;
+        return false;
+    }
+    game = Game(NO_MODE, DEFAULT, variant);
+
+    string board = tokens[i++];
+    if (board == "startpos")
+        board.clear();
+    board.erase(remove(board.begin(), board.end(), '/'), board.end());
+    if (!board.empty() && static_cast<int>(board.size()) != game.rows * game.cols)
+    {
+        error = "board needs " + to_string(game.rows * game.cols) + " cells";
+        return false;
+    }
+
+    vector<int> cells(game.rows * game.cols);
+    int marks[3] = {0, 0, 0};
+    for (int cell = 0; cell < game.rows * game.cols; ++cell)
+    {
+        char c = board.empty() ? '.' : static_cast<char>(tolower(board[cell]));
+        int mark = c == 'x' ? 1 : c == 'o' ? 2 : c == '.' ? 0 : -1;
+        if (mark < 0)
+        {
+            error = string("bad cell '") + board[cell] + "'";
+            return false;
+        }
+        marks[mark]++;
+        cells[cell] = mark;
+    }
+    if (marks[1] != marks[2] && marks[1] != marks[2] + 1)
+    {
+        error = "X must have as many marks as O or one more";
+        return false;
+    }
+
+    pair<int, int> last = {-1, -1};
+    vector<pair<int, int>> moves;
+    while (i < tokens.size())
+    {
+        if (tokens[i] == "last" && i + 1 < tokens.size())
+        {
+            if (!parseMove(tokens[i + 1], last) || last.first < 0 || last.first >= game.rows || last.second < 0 ||
+                last.second >= game.cols)
+            {
+                error = "bad move " + tokens[i + 1];
+                return false;
+            }
+            i += 2;
+        }
+        else if (tokens[i] == "moves")
+        {
+            pair<int, int> move;
+            for (i++; i < tokens.size() && parseMove(tokens[i], move); ++i)
+                moves.push_back(move);
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    game.setPosition(variant, cells, marks[1] == marks[2] ? X : O, last);
+    for (const auto &move : moves)
+    {
+        bool onBoard = move.first >= 0 && move.first < game.rows && move.second >= 0 && move.second < game.cols;
+        if (game.status != PLAYING || !onBoard || !game.isLegalMove(move.first, move.second))
+        {
+            error = "illegal move " + to_string(move.first) + "," + to_string(move.second);
+            return false;
+        }
+        game.playerMove(move.first, move.second);
+    }
+    return true;
+}
+
+/**
+ * @brief Reads search limits (`depth N`, `nodes N`, `movetime MS`, `infinite`) starting at tokens[i].
+ *
+ * A search given no limit at all gets one second.
+ *
+ * @return True if every remaining token was a valid limit.
+ */
+bool parseLimits(const vector<string> &tokens, size_t i, AnalysisLimits &limits, string &error)
+{
+    bool limited = false;
+    for (; i < tokens.size(); ++i)
+    {
+        const string &key = tokens[i];
+        if (key == "infinite")
+        {
+            limits.maxSeconds = 1e9; // until stopped (or, on the small boards, solved)
+            limited = true;
+            continue;
+        }
+        uint64_t value;
+        if (i + 1 >= tokens.size() || !parseCount(tokens[i + 1], value))
+        {
+            error = "bad limit " + key;
+            return false;
+        }
+        i++;
+        if (key == "depth")
+            limits.maxDepth = static_cast<int>(min<uint64_t>(max<uint64_t>(value, 1), 64));
+        else if (key == "nodes")
+            limits.maxNodes = max<uint64_t>(value, 1);
+        else if (key == "movetime")
+            limits.maxSeconds = max<uint64_t>(value, 1) / 1000.0;
+        else
+        {
+            error = "unknown limit " + key;
+            return false;
+        }
+        limited = true;
+    }
+    if (!limited)
+        limits.maxSeconds = 1;
+    return true;
+}
+
+/**
+ * @brief The interactive search: one position searched on a background thread until done or stopped.
+ */
+class Search
+{
+public:
+    ~Search() { stop(); }
+
+    void start(const Game &game, AnalysisLimits limits)
+    {
+        wait();
+        stopFlag = false;
+        limits.stop = &stopFlag;
+        worker = thread([game, limits] {
+            AnalysisResult result = analyzePosition(game, limits);
+            uint64_t millis = static_cast<uint64_t>(result.seconds * 1000);
+            uint64_t nps = result.seconds > 0 ? static_cast<uint64_t>(result.nodes / result.seconds) : 0;
+            printer.line("info depth " + to_string(result.depth) + " score " + to_string(result.score) +
+                         formatWin(result) + " nodes " + to_string(result.nodes) + " time " +
+                         to_string(millis) + " nps " + to_string(nps));
+            printer.line("bestmove " + formatMove(result.move));
+        });
+    }
+
+    void stop()
+    {
+        stopFlag = true;
+        wait();
+    }
+
+    void wait()
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+
+private:
+    thread worker;
+    atomic<bool> stopFlag{false};
+};
+
+int main()
+{
+    ios::sync_with_stdio(false);
+    loadEvalWeights(EVAL_WEIGHTS_FILE, evalWeights);
+
+    int threads = max(1u, thread::hardware_concurrency());
+    unique_ptr<SearchPool> pool(new SearchPool(threads));
+    Search search;
+    Game position;
+    bool havePosition = true; // false after a rejected position, so go cannot search a stale one
+
+    string line;
+    while (getline(cin, line))
+    {
+        istringstream iss(line);
+        vector<string> tokens;
+        for (string token; iss >> token;)
+            tokens.push_back(token);
+        if (tokens.empty())
+            continue;
+
+        const string &command = tokens[0];
+        string error;
+        size_t i = 1;
+        if (command == "isready")
+        {
+            printer.line("readyok");
+        }
+        else if (command == "position")
+        {
+            search.wait();
+            Game game;
+            havePosition = false;
+            if (!parsePosition(tokens, i, game, error))
+                printer.line("error " + error);
+            else if (i < tokens.size())
+                printer.line("error unexpected " + tokens[i]);
+            else
+            {
+                position = game;
+                havePosition = true;
+            }
+        }
+        else if (command == "go")
+        {
+            AnalysisLimits limits;
+            if (!havePosition)
+                printer.line("error no position");
+            else if (parseLimits(tokens, 1, limits, error))
+                search.start(position, limits);
+            else
+                printer.line("error " + error);
+        }
+        else if (command == "stop")
+        {
+            search.stop();
+        }
+        else if (command == "batch")
+        {
+            if (tokens.size() < 2)
+            {
+                printer.line("error batch needs an id");
+                continue;
+            }
+            Job job;
+            job.id = tokens[1];
+            i = 2;
+            if (parsePosition(tokens, i, job.game, error) && parseLimits(tokens, i, job.limits, error))
+                pool->submit(move(job));
+            else
+                printer.line("error " + tokens[1] + " " + error);
+        }
+        else if (command == "sync")
+        {
+            pool->drain();
+            printer.line("syncok");
+        }
+        else if (command == "setoption" && tokens.size() == 3 && tokens[1] == "threads")
+        {
+            uint64_t count;
+            if (!parseCount(tokens[2], count) || count == 0)
+            {
+                printer.line("error bad thread count " + tokens[2]);
+                continue;
+            }
+            pool.reset(); // finishes the queued positions first
+            pool.reset(new SearchPool(static_cast<int>(min<uint64_t>(count, 256))));
+        }
+        else if (command == "quit")
+        {
+            search.stop();
+            pool->cancel(); // queued batch positions are abandoned
+            return 0;
+        }
+        else
+        {
+            printer.line("error unknown command " + command);
+        }
+    }
+
+    // End of input: let the running search and the batch positions finish
+    search.wait();
+    pool.reset();
+    return 0;
+}
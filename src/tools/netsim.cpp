@@ -0,0 +1,304 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This is the entry point of the `tictactoe-netsim` tool. It runs two reliable channels (the layer
+under the UDP transport) against each other over a simulated link that drops, duplicates,
+reorders and delays datagrams in both directions, then checks that every message arrived exactly
+once and intact and reports the delivery latency percentiles. Running the same link with
+--ordered shows the cost of head-of-line blocking that in-order delivery (as over TCP) would add.
+
+Usage: tictactoe-netsim [options]
+  --messages N     messages to send (default 2000)
+  --interval MS    time between messages (default 2)
+  --size BYTES     message size (default 600, about a serialized Gomoku game)
+  --loss P         probability a datagram is dropped (default 0.05)
+  --duplicate P    probability a datagram is delivered twice (default 0.01)
+  --reorder P      probability a datagram is held back past later ones (default 0.05)
+  --delay MS       one-way delay (default 20)
+  --jitter MS      random extra delay, up to this much (default 5)
+  --ordered        deliver messages in order instead of as they arrive
+  --seed N         seed for the simulated link
+*/
+
+#include "reliable.hpp"
+#include "metrics.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+struct Options
+{
+    int messages = 2000;
+    double intervalMs = 2;
+    size_t size = 600;
+    double loss = 0.05;
+    double duplicate = 0.01;
+    double reorder = 0.05;
+    double delayMs = 20;
+    double jitterMs = 5;
+    bool ordered = false;
+    unsigned seed = random_device{}();
+};
+
+/**
+ * @brief One direction of the simulated link: datagrams wait in a queue until their delivery time.
+ */
+class SimulatedPath
+{
+public:
+    uint64_t datagrams = 0; // datagrams handed to the path
+    uint64_t dropped = 0;
+    uint64_t duplicated = 0;
+    uint64_t reordered = 0;
+
+    SimulatedPath(const Options &options, unsigned seed) : options(options), generator(seed) {}
+
+    void push(const string &datagram)
+    {
+        lock_guard<mutex> guard(lock);
+        datagrams++;
+        if (chance(options.loss))
+        {
+            dropped++;
+            return;
+        }
+        int copies = 1;
+        if (chance(options.duplicate))
+        {
+            duplicated++;
+            copies = 2;
+        }
+        for (int copy = 0; copy < copies; ++copy)
+        {
+            double delayMs = options.delayMs + uniform_real_distribution<double>(0, options.jitterMs)(generator);
+            if (chance(options.reorder))
+            {
+                reordered++;
+                delayMs += uniform_real_distribution<double>(0, max(2 * options.delayMs, 2.0))(generator);
+            }
+            uint64_t deliverAt = metricsClockMicros() + static_cast<uint64_t>(delayMs * 1000);
+            queue.push({deliverAt, order++, datagram});
+        }
+        ready.notify_all();
+    }
+
+    bool pop(string &datagram, uint64_t timeoutMicros)
+    {
+        unique_lock<mutex> guard(lock);
+        uint64_t deadline = metricsClockMicros() + timeoutMicros;
+        while (true)
+        {
+            uint64_t now = metricsClockMicros();
+            if (!queue.empty() && queue.top().deliverAt <= now)
+            {
+                datagram = queue.top().datagram;
+                queue.pop();
+                return true;
+            }
+            if (now >= deadline)
+                return false;
+            uint64_t until = queue.empty() ? deadline : min(deadline, queue.top().deliverAt);
+            ready.wait_for(guard, chrono::microseconds(until - now));
+        }
+    }
+
+private:
+    struct Pending
+    {
+        uint64_t deliverAt;
+        uint64_t order; // keeps datagrams due at the same time in sending order
+        string datagram;
+
+        bool operator>(const Pending &other) const
+        {
+            return deliverAt != other.deliverAt ? deliverAt > other.deliverAt : order > other.order;
+        }
+    };
+
+    const Options &options;
+    mt19937 generator;
+    mutex lock;
+    condition_variable ready;
+    priority_queue<Pending, vector<Pending>, greater<Pending>> queue;
+    uint64_t order = 0;
+
+    bool chance(double probability) { return uniform_real_distribution<double>(0, 1)(generator) < probability; }
+};
+
+/**
+ * @brief Endpoint of the simulated link, sending on one path and receiving from the other.
+ */
+class SimulatedLink : public DatagramLink
+{
+public:
+    SimulatedLink(SimulatedPath &outgoing, SimulatedPath &incoming) : outgoing(outgoing), incoming(incoming) {}
+
+    bool sendDatagram(const string &datagram) override
+    {
+        outgoing.push(datagram);
+        return true;
+    }
+
+    bool receiveDatagram(string &datagram, uint64_t timeoutMicros) override
+    {
+        return incoming.pop(datagram, timeoutMicros);
+    }
+
+private:
+    SimulatedPath &outgoing;
+    SimulatedPath &incoming;
+};
+
+/**
+ * @brief Builds message `index`: its index and send time, padded with a pattern that can be checked.
+ */
+string makeMessage(int index, uint64_t sentAt, size_t size)
+{
+    string message = to_string(index) + " " + to_string(sentAt) + " ";
+    while (message.size() < size)
+        message += static_cast<char>('a' + (index + message.size()) % 26);
+    return message;
+}
+
+bool parseOptions(int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--messages" && hasValue)
+            options.messages = max(1, atoi(argv[++i]));
+        else if (arg == "--interval" && hasValue)
+            options.intervalMs = max(0.0, atof(argv[++i]));
+        else if (arg == "--size" && hasValue)
+            options.size = min(static_cast<size_t>(max(1, atoi(argv[++i]))), MAX_DATAGRAM_SIZE - 5);
+        else if (arg == "--loss" && hasValue)
+            options.loss = atof(argv[++i]);
+        else if (arg == "--duplicate" && hasValue)
+            options.duplicate = atof(argv[++i]);
+        else if (arg == "--reorder" && hasValue)
+            options.reorder = atof(argv[++i]);
+        else if (arg == "--delay" && hasValue)
+            options.delayMs = max(0.0, atof(argv[++i]));
+        else if (arg == "--jitter" && hasValue)
+            options.jitterMs = max(0.0, atof(argv[++i]));
+        else if (arg == "--ordered")
+            options.ordered = true;
+        else if (arg == "--seed" && hasValue)
+            options.seed = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+        else
+        {
+            cerr << "Usage: tictactoe-netsim [--messages N] [--interval MS] [--size BYTES] [--loss P] [--duplicate P]"
+                    " [--reorder P] [--delay MS] [--jitter MS] [--ordered] [--seed N]"
+                 << endl;
+            return false;
+        }
+    }
+    if (options.loss >= 1)
+    {
+        cerr << "--loss must be below 1" << endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+
+    SimulatedPath forward(options, options.seed), backward(options, options.seed + 1);
+    SimulatedLink senderLink(forward, backward), receiverLink(backward, forward);
+    ReliableChannel sender(senderLink, options.ordered);
+    ReliableChannel receiver(receiverLink, options.ordered);
+
+    // Receive on a separate thread, checking every message as it arrives
+    vector<int> copies(options.messages, 0);
+    vector<uint64_t> latencies;
+    int corrupted = 0, outOfOrder = 0;
+    auto receiving = async(launch::async, [&] {
+        int highest = -1;
+        for (int received = 0; received < options.messages; ++received)
+        {
+            string message;
+            if (!receiver.receive(message))
+                return;
+            uint64_t now = metricsClockMicros();
+            int index = -1;
+            uint64_t sentAt = 0;
+            istringstream(message) >> index >> sentAt;
+            if (index < 0 || index >= options.messages || message != makeMessage(index, sentAt, options.size))
+            {
+                corrupted++;
+                continue;
+            }
+            copies[index]++;
+            latencies.push_back(now - sentAt);
+            outOfOrder += index < highest;
+            highest = max(highest, index);
+        }
+    });
+
+    auto interval = chrono::microseconds(static_cast<int64_t>(options.intervalMs * 1000));
+    auto nextSend = chrono::steady_clock::now();
+    for (int index = 0; index < options.messages; ++index)
+    {
+        this_thread::sleep_until(nextSend);
+        nextSend += interval;
+        if (!sender.send(makeMessage(index, metricsClockMicros(), options.size)))
+        {
+            cerr << "Channel failed while sending message " << index << endl;
+            break;
+        }
+    }
+
+    // Every message should arrive well within the time a silent peer is given
+    bool finished = receiving.wait_for(chrono::microseconds(PEER_TIMEOUT_MICROS)) == future_status::ready;
+    int missing = static_cast<int>(count(copies.begin(), copies.end(), 0));
+    int repeated = static_cast<int>(count_if(copies.begin(), copies.end(), [](int n) { return n > 1; }));
+
+    ReliableStats sent = sender.stats(), received = receiver.stats();
+    cout << (options.ordered ? "ordered" : "unordered") << " delivery, loss " << options.loss << ", duplicate "
+         << options.duplicate << ", reorder " << options.reorder << ", delay " << options.delayMs << " +"
+         << options.jitterMs << " ms, seed " << options.seed << endl;
+    cout << "messages: " << options.messages - missing << "/" << options.messages << " delivered, " << repeated
+         << " delivered twice, " << corrupted << " corrupted, " << outOfOrder << " out of order" << endl;
+    cout << "datagrams: " << forward.datagrams + backward.datagrams << " sent, "
+         << forward.dropped + backward.dropped << " dropped, " << forward.duplicated + backward.duplicated
+         << " duplicated, " << forward.reordered + backward.reordered << " reordered; " << sent.retransmits
+         << " retransmits, " << received.duplicates << " duplicates suppressed, final timeout "
+         << sent.rtoMicros / 1000.0 << " ms" << endl;
+
+    if (!latencies.empty())
+    {
+        sort(latencies.begin(), latencies.end());
+        auto percentile = [&latencies](double fraction) {
+            size_t index = min(latencies.size() - 1, static_cast<size_t>(fraction * latencies.size()));
+            return latencies[index] / 1000.0;
+        };
+        cout << fixed << setprecision(2) << "latency ms: p50 " << percentile(0.5) << ", p90 " << percentile(0.9)
+             << ", p99 " << percentile(0.99) << ", p99.9 " << percentile(0.999) << ", max "
+             << latencies.back() / 1000.0 << endl;
+    }
+
+    bool passed = finished && missing == 0 && repeated == 0 && corrupted == 0;
+    cout << (passed ? "PASS" : "FAIL") << endl;
+    if (!finished)
+    {
+        quick_exit(1); // the receiver is still blocked; skip joining it
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,495 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This is the entry point of the `tictactoe-perft` tool. It walks the game tree from a position to
+a fixed depth through the game's own rules (availablePositions, the move constructor and
+updateGameStatus), counting the positions at each depth and the games won or drawn on the way,
+and reports the walk speed. At every position it also checks that the legal-move list agrees
+with the legal-move bitmask and isLegalMove, on the classic board that the batch win detector
+agrees with updateGameStatus, and on the classic and Gomoku boards that the pattern evaluator,
+played and undone move by move along the walk, keeps the same line, threat and fork counts as
+one rebuilt from the board. Counts from the classic starting position are compared
+with the known totals (255,168 complete games), so the tool doubles as a correctness gate for
+changes to move generation.
+
+Usage: tictactoe-perft [options]
+  --variant NAME   classic, gomoku, ultimate or qubic (default classic)
+  --moves MOVES    moves played before counting, as "row,col row,col ..." (default none)
+  --depth N        plies to count to (default: to the end of the game on the classic board, else 3)
+  --threads N      walking threads (default: all cores)
+  --hash MB        cache of subtree counts shared by the threads (default 64, 0 to disable)
+  --no-verify      skip the consistency checks and measure the walk alone
+*/
+
+#include "batch.hpp"
+#include "evaluator.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+const int VERIFY_BATCH = 4096; // classic boards handed to the batch win detector at a time
+const size_t CACHE_LOCKS = 1024; // lock stripes of the shared cache
+
+struct Options
+{
+    VARIANT variant = CLASSIC;
+    vector<pair<int, int>> moves;
+    int depth = -1;
+    int threads = max(1u, thread::hardware_concurrency());
+    size_t hashMegabytes = 64;
+    bool verify = true;
+};
+
+struct PerftCounts
+{
+    uint64_t positions = 0; // positions exactly `depth` plies deep
+    uint64_t xWins = 0; // games X won within `depth` plies
+    uint64_t oWins = 0;
+    uint64_t draws = 0;
+
+    void add(const PerftCounts &other)
+    {
+        positions += other.positions;
+        xWins += other.xWins;
+        oWins += other.oWins;
+        draws += other.draws;
+    }
+
+    uint64_t games() const { return xWins + oWins + draws; }
+
+    bool operator==(const PerftCounts &other) const
+    {
+        return positions == other.positions && xWins == other.xWins && oWins == other.oWins && draws == other.draws;
+    }
+};
+
+// Known counts for the classic board from the empty position, by depth
+const PerftCounts CLASSIC_REFERENCE[10] = {
+    {1, 0, 0, 0},
+    {9, 0, 0, 0},
+    {72, 0, 0, 0},
+    {504, 0, 0, 0},
+    {3024, 0, 0, 0},
+    {15120, 1440, 0, 0},
+    {54720, 1440, 5328, 0},
+    {148176, 49392, 5328, 0},
+    {200448, 49392, 77904, 0},
+    {127872, 131184, 77904, 46080},
+};
+
+/**
+ * @brief Hashes everything the rules look at: the marks, the player to move and, in Ultimate, the
+ *        previous move.
+ */
+uint64_t positionHash(const Game &game)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+    for (const auto &row : game.grid)
+    {
+        for (int cell : row)
+            mix(cell);
+    }
+    mix(game.activeTurn);
+    if (game.variant == ULTIMATE)
+        mix((game.lastMove.first + 1) * 16 + game.lastMove.second + 1);
+    return hash ^ (hash >> 29);
+}
+
+/**
+ * @brief Subtree counts shared by all threads, one entry per slot, guarded by striped locks.
+ */
+class PerftCache
+{
+public:
+    explicit PerftCache(size_t megabytes)
+    {
+        size_t slots = 1;
+        while (slots * 2 * sizeof(Entry) <= megabytes * 1024 * 1024)
+            slots *= 2;
+        if (megabytes > 0)
+            entries.assign(slots, Entry{0, -1, {}});
+    }
+
+    bool lookup(uint64_t key, int depth, PerftCounts &counts)
+    {
+        if (entries.empty())
+            return false;
+        size_t slot = key & (entries.size() - 1);
+        lock_guard<mutex> guard(locks[slot % CACHE_LOCKS]);
+        const Entry &entry = entries[slot];
+        if (entry.key != key || entry.depth != depth)
+            return false;
+        counts = entry.counts;
+        return true;
+    }
+
+    void store(uint64_t key, int depth, const PerftCounts &counts)
+    {
+        if (entries.empty())
+            return;
+        size_t slot = key & (entries.size() - 1);
+        lock_guard<mutex> guard(locks[slot % CACHE_LOCKS]);
+        entries[slot] = Entry{key, depth, counts};
+    }
+
+private:
+    struct Entry
+    {
+        uint64_t key;
+        int depth; // plies below the position, -1 if the slot is empty
+        PerftCounts counts;
+    };
+
+    vector<Entry> entries;
+    array<mutex, CACHE_LOCKS> locks;
+};
+
+/**
+ * @brief One walking thread: its node count, and the consistency checks of the positions it visits.
+ */
+class PerftWalker
+{
+public:
+    uint64_t visited = 0; // positions walked, not counting those under a cache hit
+    uint64_t checked = 0; // positions verified
+    uint64_t mismatches = 0;
+
+    PerftWalker(PerftCache &cache, bool verify) : cache(cache), verify(verify) {}
+
+    /**
+     * @brief Counts the tree below a position, which the walker has not seen before.
+     */
+    PerftCounts walk(Game &game, int depth)
+    {
+        tracking = verify && (game.variant == CLASSIC || game.variant == GOMOKU);
+        if (tracking)
+        {
+            const LineTable &table = getLineTable(game.rows, game.cols, game.winLength);
+            incremental.reset(table);
+            incremental.setBoard(game.grid);
+            rebuilt.reset(table);
+        }
+        return walkTree(game, depth);
+    }
+
+    /**
+     * @brief Checks the boards still waiting for the batch win detector.
+     */
+    void flush()
+    {
+        if (xMasks.empty())
+            return;
+        vector<uint8_t> results(xMasks.size());
+        classifyBoards(xMasks.data(), oMasks.data(), results.data(), xMasks.size());
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            if (results[i] != expected[i])
+                report("batch win detector says " + to_string(results[i]) + ", updateGameStatus says " +
+                       to_string(expected[i]) + " for X " + to_string(xMasks[i]) + " O " + to_string(oMasks[i]));
+        }
+        xMasks.clear();
+        oMasks.clear();
+        expected.clear();
+    }
+
+private:
+    PerftCache &cache;
+    bool verify;
+    vector<uint16_t> xMasks, oMasks; // classic boards waiting for the batch win detector
+    vector<uint8_t> expected; // their status according to updateGameStatus
+    bool tracking = false; // the evaluators below follow the walk
+    PatternEvaluator incremental; // played and undone along the walk
+    PatternEvaluator rebuilt; // rebuilt from the board at every position, for comparison
+
+    PerftCounts walkTree(Game &game, int depth)
+    {
+        PerftCounts counts;
+        visited++;
+        if (verify)
+            check(game);
+        if (game.status != PLAYING)
+        {
+            counts.positions = depth == 0;
+            counts.xWins = game.status == X_WIN;
+            counts.oWins = game.status == O_WIN;
+            counts.draws = game.status == DRAW;
+            return counts;
+        }
+        if (depth == 0)
+        {
+            counts.positions = 1;
+            return counts;
+        }
+
+        uint64_t key = depth > 1 ? positionHash(game) : 0; // one ply is cheaper to count than to look up
+        if (depth > 1 && cache.lookup(key, depth, counts))
+            return counts;
+
+        int player = game.activeTurn == X ? 0 : 1;
+        for (const auto &move : game.availablePositions())
+        {
+            int cell = move.first * game.cols + move.second;
+            if (tracking)
+                incremental.play(cell, player);
+            Game child(game, move);
+            counts.add(walkTree(child, depth - 1));
+            if (tracking)
+                incremental.undo(cell, player);
+        }
+        if (depth > 1)
+            cache.store(key, depth, counts);
+        return counts;
+    }
+
+    void check(Game &game)
+    {
+        checked++;
+        if (game.variant == CLASSIC)
+        {
+            uint16_t x, o;
+            packBoard(game, x, o);
+            xMasks.push_back(x);
+            oMasks.push_back(o);
+            expected.push_back(static_cast<uint8_t>(game.status));
+            if (xMasks.size() == VERIFY_BATCH)
+                flush();
+        }
+        if (tracking)
+            checkEvaluator(game);
+        if (game.status != PLAYING)
+            return; // finished games have no moves, but availablePositions still lists the empty cells
+
+        uint64_t mask[BOARD_MASK_WORDS];
+        int count = game.legalMoveMask(mask);
+        vector<pair<int, int>> moves = game.availablePositions();
+        if (static_cast<int>(moves.size()) != count)
+        {
+            report(to_string(moves.size()) + " moves listed but " + to_string(count) + " in the legal-move mask: " +
+                   game.serialize());
+            return;
+        }
+        for (const auto &move : moves)
+        {
+            int index = move.first * game.cols + move.second;
+            if (!(mask[index / 64] >> (index % 64) & 1) || !game.isLegalMove(move.first, move.second))
+            {
+                report("listed move " + to_string(move.first) + "," + to_string(move.second) + " is not legal: " +
+                       game.serialize());
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Compares the counts of the incrementally updated evaluator with a rebuilt one.
+     */
+    void checkEvaluator(const Game &game)
+    {
+        rebuilt.setBoard(game.grid);
+        for (int player = 0; player < 2; ++player)
+        {
+            bool same = incremental.threats(player) == rebuilt.threats(player) &&
+                        incremental.forks(player) == rebuilt.forks(player);
+            for (int marks = 0; marks <= game.winLength; ++marks)
+                same = same && incremental.openLines(player, marks) == rebuilt.openLines(player, marks);
+            if (!same)
+            {
+                report("incremental evaluator counts differ from a rebuilt evaluator for player " +
+                       to_string(player) + ": " + game.serialize());
+                return;
+            }
+        }
+    }
+
+    void report(const string &problem)
+    {
+        static mutex printing;
+        if (mismatches++ < 5)
+        {
+            lock_guard<mutex> guard(printing);
+            cerr << "Mismatch: " << problem << endl;
+        }
+    }
+};
+
+/**
+ * @brief Counts the tree below `root` to `depth` plies, splitting it across threads.
+ *
+ * The positions a few plies down are shared out until there are several per thread; each thread
+ * takes the next one when it finishes the last.
+ */
+PerftCounts perft(const Game &root, int depth, int threads, PerftCache &cache, bool verify, uint64_t &visited,
+                  uint64_t &checked, uint64_t &mismatches)
+{
+    PerftCounts counts;
+    PerftWalker splitter(cache, verify);
+    Game first = root;
+    if (verify)
+        splitter.walk(first, 0); // check the root itself
+    vector<Game> frontier = {root};
+    int frontierDepth = 0;
+    while (frontierDepth < depth - 1 && frontier.size() < 8 * static_cast<size_t>(threads))
+    {
+        vector<Game> next;
+        for (Game &game : frontier)
+        {
+            for (const auto &move : game.availablePositions())
+            {
+                Game child(game, move);
+                if (child.status == PLAYING)
+                    next.push_back(child);
+                else
+                    counts.add(splitter.walk(child, depth - frontierDepth - 1)); // finished before the last ply
+            }
+        }
+        frontier.swap(next);
+        frontierDepth++;
+    }
+
+    vector<unique_ptr<PerftWalker>> walkers;
+    vector<PerftCounts> results(frontier.size());
+    atomic<size_t> nextIndex{0};
+    vector<thread> pool;
+    for (int t = 0; t < threads; ++t)
+    {
+        walkers.emplace_back(new PerftWalker(cache, verify));
+        PerftWalker *walker = walkers.back().get();
+        pool.emplace_back([&, walker] {
+            for (size_t i; (i = nextIndex++) < frontier.size();)
+                results[i] = walker->walk(frontier[i], depth - frontierDepth);
+            walker->flush();
+        });
+    }
+    for (thread &worker : pool)
+        worker.join();
+    splitter.flush();
+
+    for (const PerftCounts &result : results)
+        counts.add(result);
+    visited = splitter.visited;
+    checked = splitter.checked;
+    mismatches = splitter.mismatches;
+    for (const auto &walker : walkers)
+    {
+        visited += walker->visited;
+        checked += walker->checked;
+        mismatches += walker->mismatches;
+    }
+    return counts;
+}
+
+bool parseOptions(int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--variant" && hasValue)
+        {
+            string name = argv[++i];
+            if (name == "classic") options.variant = CLASSIC;
+            else if (name == "gomoku") options.variant = GOMOKU;
+            else if (name == "ultimate") options.variant = ULTIMATE;
+            else if (name == "qubic") options.variant = QUBIC;
+            else
+            {
+                cerr << "Unknown variant: " << name << endl;
+                return false;
+            }
+        }
+        else if (arg == "--moves" && hasValue)
+        {
+            istringstream iss(argv[++i]);
+            int row, col;
+            char comma;
+            while (iss >> row >> comma >> col && comma == ',')
+                options.moves.push_back({row, col});
+            if (!iss.eof())
+            {
+                cerr << "Moves must be given as \"row,col row,col ...\"" << endl;
+                return false;
+            }
+        }
+        else if (arg == "--depth" && hasValue)
+            options.depth = max(0, atoi(argv[++i]));
+        else if (arg == "--threads" && hasValue)
+            options.threads = max(1, atoi(argv[++i]));
+        else if (arg == "--hash" && hasValue)
+            options.hashMegabytes = max(0, atoi(argv[++i]));
+        else if (arg == "--no-verify")
+            options.verify = false;
+        else
+        {
+            cerr << "Usage: tictactoe-perft [--variant NAME] [--moves \"row,col ...\"] [--depth N] [--threads N]"
+                    " [--hash MB] [--no-verify]"
+                 << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+
+    Game root(NO_MODE, DEFAULT, options.variant);
+    for (const auto &move : options.moves)
+    {
+        if (root.status != PLAYING || !root.isLegalMove(move.first, move.second))
+        {
+            cerr << "Illegal move " << move.first << "," << move.second << endl;
+            return 1;
+        }
+        root.playerMove(move.first, move.second);
+    }
+    int depth = options.depth >= 0 ? options.depth : options.variant == CLASSIC ? 9 : 3;
+    bool reference = options.variant == CLASSIC && options.moves.empty();
+
+    cout << "depth    positions        games       X wins       O wins        draws     time   positions/sec" << endl;
+    PerftCache cache(options.hashMegabytes);
+    bool failed = false;
+    double totalSeconds = 0;
+    for (int d = 1; d <= depth; ++d)
+    {
+        uint64_t visited = 0, checked = 0, mismatches = 0;
+        auto start = chrono::steady_clock::now();
+        PerftCounts counts = perft(root, d, options.threads, cache, options.verify, visited, checked, mismatches);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        totalSeconds += seconds;
+
+        cout << setw(5) << d << setw(13) << counts.positions << setw(13) << counts.games() << setw(13) << counts.xWins
+             << setw(13) << counts.oWins << setw(13) << counts.draws << fixed << setprecision(3) << setw(9) << seconds
+             << setprecision(0) << setw(16) << (seconds > 0 ? visited / seconds : 0);
+        if (reference && d < 10)
+        {
+            bool matches = counts == CLASSIC_REFERENCE[d];
+            cout << (matches ? "  ok" : "  WRONG");
+            failed |= !matches;
+        }
+        cout << endl;
+        if (mismatches > 0)
+        {
+            cout << mismatches << " of " << checked << " positions failed the consistency checks" << endl;
+            failed = true;
+        }
+    }
+    cout << fixed << setprecision(3) << "total " << totalSeconds << " s, " << options.threads << " threads"
+         << (options.verify ? ", consistency checks on" : "") << endl;
+    cout << (failed ? "FAIL" : "PASS") << endl;
+    return failed ? 1 : 0;
+}
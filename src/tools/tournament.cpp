@@ -0,0 +1,414 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This is the entry point of the `tictactoe-tournament` tool. It plays engine configurations against
+each other over many games in parallel, using randomized openings that each pair of engines plays
+once from each side, and reports the Elo difference with a 95% confidence interval. With --sprt it
+stops a match as soon as a sequential probability ratio test accepts or rejects the hypothesis that
+the first engine is stronger by the given Elo margin. With --ai-service the games are hosted the
+way a server would host them: the games in flight ask a shared AI service for their moves, which
+merges requests for the same position, caches answers and searches on its own worker threads.
+
+Usage: tictactoe-tournament [options] engine engine [engine...]
+  engines: easy, medium, hard, expert, or level0 to level9 of the strength ladder; a level can
+           take its own evaluator weights as levelN:FILE, so two weight sets can be compared
+  --games N          games per match (default 1000)
+  --threads N        worker threads (default: all cores)
+  --opening-plies N  random moves played before the engines take over (default 2)
+  --variant NAME     classic, gomoku, ultimate or qubic (default classic)
+  --sprt E0 E1       test H0: elo <= E0 against H1: elo >= E1 (alpha = beta = 0.05), deciding
+                     no earlier than after 64 games
+  --seed N           seed for the random openings
+  --ai-service       choose the moves of easy/medium/hard/expert through the AI service
+  --hosted N         games in flight with --ai-service (default 64); --threads sets its workers
+  --deadline MS      time after which a service request gets a fallback move (default 10000)
+*/
+
+#include "ai.hpp"
+#include "aiservice.hpp"
+#include "metrics.hpp"
+#include "strength.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+
+using namespace std;
+
+// Game pairs played before the SPRT may stop a match, so a few early decisive games (whose score
+// variance is near zero) cannot end it
+const int SPRT_MIN_PAIRS = 32;
+
+struct EngineConfig
+{
+    string name; // name used on the command line
+    DIFFICULTY difficulty; // difficulty the engine plays at
+    int level; // strength ladder level, or -1 to play the difficulty through computerMove
+    shared_ptr<EvalWeights> weights; // evaluator weights of a ladder level, or null for the defaults
+};
+
+// Engines that can be entered in a tournament; "level0" to "level9" enter a strength ladder level
+const EngineConfig ENGINES[] = {
+    {"easy", EASY, -1, nullptr},
+    {"medium", MEDIUM, -1, nullptr},
+    {"hard", HARD, -1, nullptr},
+    {"expert", EXPERT, -1, nullptr},
+};
+
+struct Options
+{
+    int games = 1000;
+    int threads = max(1u, thread::hardware_concurrency());
+    int openingPlies = 2;
+    VARIANT variant = CLASSIC;
+    bool sprt = false;
+    double elo0 = 0;
+    double elo1 = 10;
+    double alpha = 0.05;
+    double beta = 0.05;
+    unsigned seed = random_device{}();
+    bool aiService = false;
+    int hosted = 64;
+    double deadlineSeconds = 10;
+    vector<EngineConfig> engines;
+};
+
+struct MatchStats
+{
+    int wins = 0; // wins of the first engine
+    int draws = 0;
+    int losses = 0; // losses of the first engine
+
+    int games() const { return wins + draws + losses; }
+    double score() const { return (wins + 0.5 * draws) / games(); }
+
+    /**
+     * @brief Returns the variance of a single game's score (1, 0.5 or 0).
+     */
+    double variance() const
+    {
+        double s = score();
+        return (wins * (1 - s) * (1 - s) + draws * (0.5 - s) * (0.5 - s) + losses * s * s) / games();
+    }
+};
+
+/**
+ * @brief Converts an expected score to an Elo difference.
+ */
+double eloFromScore(double score)
+{
+    score = min(max(score, 1e-6), 1 - 1e-6);
+    return -400 * log10(1 / score - 1);
+}
+
+/**
+ * @brief Converts an Elo difference to an expected score.
+ */
+double scoreFromElo(double elo)
+{
+    return 1 / (1 + pow(10, -elo / 400));
+}
+
+/**
+ * @brief Returns the log-likelihood ratio of H1 (elo1) against H0 (elo0), using the normal
+ *        approximation of the per-game score distribution.
+ */
+double sprtLlr(const MatchStats &stats, double elo0, double elo1)
+{
+    if (stats.games() == 0)
+        return 0;
+    double s0 = scoreFromElo(elo0), s1 = scoreFromElo(elo1);
+    double variance = max(stats.variance(), 1e-3); // all-draw matches still carry information
+    return stats.games() * (s1 - s0) * (2 * stats.score() - s0 - s1) / (2 * variance);
+}
+
+/**
+ * @brief Plays random legal moves from the start to create an opening that is still in play.
+ */
+vector<pair<int, int>> randomOpening(VARIANT variant, int plies, mt19937 &generator)
+{
+    while (true)
+    {
+        Game game(SINGLE_PLAYER, DEFAULT, variant);
+        vector<pair<int, int>> opening;
+        for (int i = 0; i < plies && game.status == PLAYING; ++i)
+        {
+            vector<pair<int, int>> moves = game.availablePositions();
+            pair<int, int> move = moves[generator() % moves.size()];
+            game.playerMove(move.first, move.second);
+            opening.push_back(move);
+        }
+        if (game.status == PLAYING)
+            return opening;
+    }
+}
+
+/**
+ * @brief Plays one game between two engines from an opening.
+ *
+ * @param service The AI service choosing the moves of the difficulty engines, or null to search
+ *                on the calling thread.
+ * @return The final game status.
+ */
+GAMESTATUS playGame(const EngineConfig &xEngine, const EngineConfig &oEngine, const vector<pair<int, int>> &opening, VARIANT variant,
+                    AiService *service, double deadlineSeconds)
+{
+    Game game(SINGLE_PLAYER, DEFAULT, variant);
+    for (const pair<int, int> &move : opening)
+        game.playerMove(move.first, move.second);
+
+    while (game.status == PLAYING)
+    {
+        const EngineConfig &engine = (game.activeTurn == X) ? xEngine : oEngine;
+        game.difficulty = engine.difficulty;
+        pair<int, int> move;
+        if (engine.level >= 0)
+            move = strengthMove(game, engine.level, engine.weights ? *engine.weights : evalWeights);
+        else if (service)
+            move = service->requestMove(game, game.activeTurn, deadlineSeconds).get().move;
+        else
+            move = computerMove(game, game.activeTurn);
+        game.playerMove(move.first, move.second);
+    }
+    return game.status;
+}
+
+/**
+ * @brief Prints the current standing of a match.
+ */
+void printStats(const EngineConfig &first, const EngineConfig &second, const MatchStats &stats, const Options &options)
+{
+    if (stats.games() == 0)
+    {
+        cout << first.name << " vs " << second.name << ": no games played" << endl;
+        return;
+    }
+    double score = stats.score();
+    double margin = 1.96 * sqrt(stats.variance() / stats.games());
+    cout << fixed << setprecision(1)
+         << first.name << " vs " << second.name << ": " << stats.games() << " games  +"
+         << stats.wins << " =" << stats.draws << " -" << stats.losses
+         << "  score " << 100 * score << "%  Elo " << showpos << eloFromScore(score)
+         << " [" << eloFromScore(score - margin) << ", " << eloFromScore(score + margin) << "]" << noshowpos;
+    if (options.sprt)
+    {
+        cout << setprecision(2) << "  LLR " << sprtLlr(stats, options.elo0, options.elo1)
+             << " [" << log(options.beta / (1 - options.alpha)) << ", " << log((1 - options.beta) / options.alpha) << "]";
+    }
+    cout << endl;
+}
+
+/**
+ * @brief Plays a match between two engines across all worker threads.
+ *
+ * Games are played in pairs from the same random opening with colors swapped. The match ends
+ * after the requested number of games, or earlier when the SPRT reaches a decision.
+ */
+void runMatch(const EngineConfig &first, const EngineConfig &second, const Options &options, AiService *service)
+{
+    MatchStats stats;
+    mutex statsLock;
+    atomic<int> nextPair(0);
+    atomic<bool> stop(false);
+    int pairs = (options.games + 1) / 2;
+    double lowerBound = log(options.beta / (1 - options.alpha));
+    double upperBound = log((1 - options.beta) / options.alpha);
+
+    auto worker = [&]() {
+        while (!stop)
+        {
+            int pair = nextPair++;
+            if (pair >= pairs)
+                break;
+
+            mt19937 openingGenerator(options.seed ^ (static_cast<unsigned>(pair) * 2654435761u));
+            vector<std::pair<int, int>> opening = randomOpening(options.variant, options.openingPlies, openingGenerator);
+            GAMESTATUS firstAsX = playGame(first, second, opening, options.variant, service, options.deadlineSeconds);
+            GAMESTATUS firstAsO = playGame(second, first, opening, options.variant, service, options.deadlineSeconds);
+
+            lock_guard<mutex> guard(statsLock);
+            stats.wins += (firstAsX == X_WIN) + (firstAsO == O_WIN);
+            stats.losses += (firstAsX == O_WIN) + (firstAsO == X_WIN);
+            stats.draws += (firstAsX == DRAW) + (firstAsO == DRAW);
+
+            if (stats.games() % 100 == 0)
+                printStats(first, second, stats, options);
+            if (options.sprt && stats.games() >= 2 * SPRT_MIN_PAIRS)
+            {
+                double llr = sprtLlr(stats, options.elo0, options.elo1);
+                if (llr <= lowerBound || llr >= upperBound)
+                    stop = true;
+            }
+        }
+    };
+
+    // With the service the threads here only host games; the searching happens in the service
+    int gameThreads = service ? options.hosted : options.threads;
+    vector<thread> workers;
+    for (int i = 0; i < gameThreads; ++i)
+        workers.emplace_back(worker);
+    for (thread &t : workers)
+        t.join();
+
+    printStats(first, second, stats, options);
+    if (options.sprt)
+    {
+        double llr = sprtLlr(stats, options.elo0, options.elo1);
+        if (stats.games() < 2 * SPRT_MIN_PAIRS)
+            cout << "SPRT: no decision, fewer than " << 2 * SPRT_MIN_PAIRS << " games played" << endl;
+        else if (llr >= upperBound)
+            cout << "SPRT: H1 accepted (" << first.name << " is stronger by at least " << options.elo1 << " Elo)" << endl;
+        else if (llr <= lowerBound)
+            cout << "SPRT: H0 accepted (" << first.name << " is not stronger by more than " << options.elo0 << " Elo)" << endl;
+        else
+            cout << "SPRT: no decision after " << stats.games() << " games" << endl;
+    }
+}
+
+/**
+ * @brief Prints how the AI service answered the requests of the games it hosted.
+ */
+void printServiceStats(const AiServiceStats &stats)
+{
+    MetricsSnapshot snapshot = collectMetrics();
+    const HistogramSnapshot &latency = snapshot.histograms[AI_SERVICE_LATENCY];
+    const HistogramSnapshot &queueWait = snapshot.histograms[AI_SERVICE_QUEUE_WAIT];
+    cout << "AI service: " << stats.requests << " requests, " << stats.searches << " searches, "
+         << stats.cacheHits << " cache hits, " << stats.coalesced << " coalesced, " << stats.fallbacks
+         << " fallbacks, peak queue " << stats.peakQueueDepth << endl;
+    cout << setprecision(3) << "  latency p50 " << latency.percentile(0.5) / 1000.0 << " ms, p99 "
+         << latency.percentile(0.99) / 1000.0 << " ms; queue wait p50 " << queueWait.percentile(0.5) / 1000.0
+         << " ms, p99 " << queueWait.percentile(0.99) / 1000.0 << " ms" << endl;
+}
+
+/**
+ * @brief Parses the command line.
+ * @return False (after printing the reason) if the arguments are invalid.
+ */
+bool parseOptions(int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--games" && hasValue)
+            options.games = atoi(argv[++i]);
+        else if (arg == "--threads" && hasValue)
+            options.threads = max(1, atoi(argv[++i]));
+        else if (arg == "--opening-plies" && hasValue)
+            options.openingPlies = max(0, atoi(argv[++i]));
+        else if (arg == "--seed" && hasValue)
+            options.seed = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--ai-service")
+            options.aiService = true;
+        else if (arg == "--hosted" && hasValue)
+            options.hosted = max(1, atoi(argv[++i]));
+        else if (arg == "--deadline" && hasValue)
+            options.deadlineSeconds = max(0, atoi(argv[++i])) / 1000.0;
+        else if (arg == "--sprt" && i + 2 < argc)
+        {
+            options.sprt = true;
+            options.elo0 = atof(argv[++i]);
+            options.elo1 = atof(argv[++i]);
+        }
+        else if (arg == "--variant" && hasValue)
+        {
+            string name = argv[++i];
+            if (name == "classic") options.variant = CLASSIC;
+            else if (name == "gomoku") options.variant = GOMOKU;
+            else if (name == "ultimate") options.variant = ULTIMATE;
+            else if (name == "qubic") options.variant = QUBIC;
+            else
+            {
+                cerr << "Unknown variant: " << name << endl;
+                return false;
+            }
+        }
+        else
+        {
+            bool found = false;
+            for (const EngineConfig &engine : ENGINES)
+            {
+                if (engine.name == arg)
+                {
+                    options.engines.push_back(engine);
+                    found = true;
+                }
+            }
+            if (!found && arg.compare(0, 5, "level") == 0 && arg.size() > 5 && isdigit(static_cast<unsigned char>(arg[5])))
+            {
+                char *end;
+                long level = strtol(arg.c_str() + 5, &end, 10);
+                size_t colon = arg.find(':');
+                if (static_cast<size_t>(end - arg.c_str()) != min(colon, arg.size()))
+                {
+                    cerr << "Unknown engine or option: " << arg << endl;
+                    return false;
+                }
+                shared_ptr<EvalWeights> weights;
+                if (colon != string::npos)
+                {
+                    weights = make_shared<EvalWeights>(evalWeights);
+                    if (!loadEvalWeights(arg.substr(colon + 1), *weights))
+                    {
+                        cerr << "Cannot read weights file: " << arg.substr(colon + 1) << endl;
+                        return false;
+                    }
+                }
+                if (level < STRENGTH_LEVELS)
+                {
+                    options.engines.push_back({arg, DEFAULT, static_cast<int>(level), weights});
+                    found = true;
+                }
+            }
+            if (!found)
+            {
+                cerr << "Unknown engine or option: " << arg << endl;
+                return false;
+            }
+        }
+    }
+
+    if (options.engines.size() < 2)
+    {
+        cerr << "Usage: tictactoe-tournament [--games N] [--threads N] [--opening-plies N] [--variant NAME] [--sprt E0 E1] [--seed N] [--ai-service [--hosted N] [--deadline MS]] engine engine [engine...]" << endl;
+        cerr << "Engines:";
+        for (const EngineConfig &engine : ENGINES)
+            cerr << " " << engine.name;
+        cerr << " level0..level" << STRENGTH_LEVELS - 1 << " (optionally levelN:WEIGHTS_FILE)" << endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    loadEvalWeights(EVAL_WEIGHTS_FILE, evalWeights); // the game's weights, unless an engine brings its own
+    if (!parseOptions(argc, argv, options))
+        return 1;
+
+    logEngineStats = false;
+    unique_ptr<AiService> service;
+    if (options.aiService)
+        service.reset(new AiService(options.threads));
+
+    // Every engine plays every other engine
+    for (size_t i = 0; i < options.engines.size(); ++i)
+    {
+        for (size_t j = i + 1; j < options.engines.size(); ++j)
+        {
+            runMatch(options.engines[i], options.engines[j], options, service.get());
+        }
+    }
+
+    if (service)
+        printServiceStats(service->stats());
+    return 0;
+}
@@ -0,0 +1,218 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This file implements event tracing. Each thread that records a span gets a fixed-size ring
+buffer; the thread is its only writer and publishes each event by advancing an atomic head, so
+recording never takes a lock. When the ring is full the oldest spans are overwritten. Writing
+the trace copies every ring and drops slots that may have been overwritten during the copy.
+Buffers of exited threads are kept so their spans still appear. Timestamps come from the
+monotonic clock, which all processes on a host share, so the traces of both multiplayer
+processes line up when merged into one file.
+*/
+
+#include "trace.hpp"
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#define TRACE_PROCESS_ID _getpid()
+#else
+#include <unistd.h>
+#define TRACE_PROCESS_ID getpid()
+#endif
+
+atomic<bool> tracingEnabled(false);
+
+namespace
+{
+const uint64_t TRACE_BUFFER_EVENTS = 1 << 14; // spans kept per thread
+
+struct TraceEvent
+{
+    atomic<const char *> name;
+    atomic<uint64_t> start;
+    atomic<uint64_t> end;
+};
+
+struct TraceBuffer
+{
+    atomic<uint64_t> head; // events ever written; slot = index % TRACE_BUFFER_EVENTS
+    int threadId; // small id shown as tid in the trace
+    string threadName; // guarded by the registry lock
+    TraceEvent events[TRACE_BUFFER_EVENTS];
+};
+
+struct TraceRegistry
+{
+    mutex lock; // guards buffers and thread names
+    vector<shared_ptr<TraceBuffer>> buffers; // every thread that ever traced, in creation order
+};
+
+TraceRegistry &registry()
+{
+    static TraceRegistry instance;
+    return instance;
+}
+
+TraceBuffer &localBuffer()
+{
+    thread_local shared_ptr<TraceBuffer> buffer;
+    if (!buffer)
+    {
+        buffer.reset(new TraceBuffer());
+        TraceRegistry &shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        buffer->threadId = static_cast<int>(shared.buffers.size()) + 1;
+        shared.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+/**
+ * @brief Writes a string as a JSON string literal.
+ */
+void writeJsonString(ostream &out, const string &text)
+{
+    out << '"';
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if (static_cast<unsigned char>(c) >= 0x20)
+            out << c;
+    }
+    out << '"';
+}
+
+class TraceFlusher
+{
+public:
+    ~TraceFlusher()
+    {
+        if (!path.empty())
+            writeTrace(path);
+    }
+
+    string path; // written at exit when set
+};
+
+TraceFlusher &flusher()
+{
+    registry(); // constructed first so it outlives the final flush
+    static TraceFlusher instance;
+    return instance;
+}
+}
+
+/**
+ * @brief Returns the trace timestamp in nanoseconds.
+ */
+uint64_t traceClockNanos()
+{
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Appends a finished span to the calling thread's ring buffer.
+ */
+void recordSpan(const char *name, uint64_t startNanos, uint64_t endNanos)
+{
+    TraceBuffer &buffer = localBuffer();
+    uint64_t index = buffer.head.load(memory_order_relaxed);
+    TraceEvent &event = buffer.events[index % TRACE_BUFFER_EVENTS];
+    event.name.store(name, memory_order_relaxed);
+    event.start.store(startNanos, memory_order_relaxed);
+    event.end.store(endNanos, memory_order_relaxed);
+    buffer.head.store(index + 1, memory_order_release);
+}
+
+/**
+ * @brief Names the calling thread in the trace viewer.
+ */
+void setTraceThreadName(const char *name)
+{
+    TraceBuffer &buffer = localBuffer();
+    lock_guard<mutex> guard(registry().lock);
+    buffer.threadName = name;
+}
+
+/**
+ * @brief Writes every recorded span to a file in the Chrome trace event format.
+ *
+ * @param path The output file path.
+ * @return True if the file was written.
+ */
+bool writeTrace(const string &path)
+{
+    ofstream out(path, ios::trunc);
+    if (!out)
+    {
+        cerr << "Failed to open trace file " << path << endl;
+        return false;
+    }
+
+    int pid = static_cast<int>(TRACE_PROCESS_ID);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"args\":{\"name\":\"TicTacToe " << pid << "\"}}";
+
+    TraceRegistry &shared = registry();
+    lock_guard<mutex> guard(shared.lock);
+    out.setf(ios::fixed);
+    out.precision(3);
+    for (const shared_ptr<TraceBuffer> &buffer : shared.buffers)
+    {
+        if (!buffer->threadName.empty())
+        {
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << buffer->threadId
+                << ",\"args\":{\"name\":";
+            writeJsonString(out, buffer->threadName);
+            out << "}}";
+        }
+
+        // Copy the ring, then drop the slots the owner may have overwritten while we copied
+        uint64_t head = buffer->head.load(memory_order_acquire);
+        uint64_t first = head > TRACE_BUFFER_EVENTS ? head - TRACE_BUFFER_EVENTS : 0;
+        vector<pair<const char *, pair<uint64_t, uint64_t>>> copied;
+        copied.reserve(head - first);
+        for (uint64_t index = first; index < head; ++index)
+        {
+            const TraceEvent &event = buffer->events[index % TRACE_BUFFER_EVENTS];
+            copied.push_back({event.name.load(memory_order_relaxed),
+                              {event.start.load(memory_order_relaxed), event.end.load(memory_order_relaxed)}});
+        }
+        // (the slot for the next, unpublished event is the oldest one, so it is dropped too). The
+        // fence keeps the slot reads above from being reordered after this second load of head.
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t headAfter = buffer->head.load(memory_order_relaxed) + 1;
+        uint64_t valid = headAfter > TRACE_BUFFER_EVENTS ? headAfter - TRACE_BUFFER_EVENTS : 0;
+
+        for (uint64_t index = max(first, valid); index < head; ++index)
+        {
+            const auto &event = copied[index - first];
+            out << ",\n{\"name\":";
+            writeJsonString(out, event.first);
+            out << ",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << buffer->threadId
+                << ",\"ts\":" << event.second.first / 1000.0 << ",\"dur\":"
+                << (event.second.second - event.second.first) / 1000.0 << "}";
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+/**
+ * @brief Enables tracing and writes the trace to "<prefix>-<process id>.json" when the program exits.
+ *
+ * The process id keeps the two multiplayer processes from overwriting each other's trace.
+ */
+void startTracing(const string &prefix)
+{
+    flusher().path = prefix + "-" + to_string(TRACE_PROCESS_ID) + ".json";
+    tracingEnabled.store(true);
+}
@@ -0,0 +1,480 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This file implements the multiplayer message transports. The TCP transport sends null-terminated
+messages over the connected socket. The shared-memory transport maps one segment into both
+processes holding a ring buffer of fixed-size records per direction. Sending writes straight into
+the next free record and publishes it with an atomic counter; receiving spins briefly on that
+counter before sleeping on a futex, and the sender only makes the wake-up system call when the
+receiver is actually asleep, so a message exchanged while the peer is waiting costs no syscalls.
+Each side records its process id in the segment, and a side that wakes from the futex without
+news checks that the peer process still exists, so a crashed peer reads as a disconnect.
+The UDP transport runs a reliable channel over a bound UDP socket, accepting datagrams only from
+the peer it was connected to.
+*/
+
+#include "transport.hpp"
+#include "metrics.hpp"
+#include <atomic>
+#include <cstring>
+#include <random>
+#include <thread>
+
+#ifdef __linux__
+#include <climits>
+#include <csignal>
+#include <cerrno>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+unique_ptr<Transport> transport;
+
+namespace
+{
+const uint32_t RING_SLOTS = 16; // records per direction
+const size_t RECORD_SIZE = 1024; // bytes per record, enough for a serialized 15x15 game
+const int SPIN_LIMIT = 4096; // polls before sleeping on the futex
+
+/**
+ * @brief Number of polls before sleeping; spinning cannot help when the peer shares our only core.
+ */
+int spinLimit()
+{
+    static const int limit = thread::hardware_concurrency() > 1 ? SPIN_LIMIT : 0;
+    return limit;
+}
+
+static_assert(atomic<uint32_t>::is_always_lock_free, "shared-memory transport needs lock-free 32-bit atomics");
+}
+
+struct MessageRecord
+{
+    uint32_t length; // message length, excluding the terminator
+    char data[RECORD_SIZE - sizeof(uint32_t)]; // message bytes
+};
+
+/**
+ * @brief Single-producer single-consumer ring of records for one direction.
+ *
+ * `head` counts records written and `tail` records read; both only grow, so the ring is empty
+ * when they are equal and full when they differ by RING_SLOTS. Each counter is on its own cache
+ * line so the two processes do not contend on the same line.
+ */
+struct MessageRing
+{
+    alignas(64) atomic<uint32_t> head; // written by the sender
+    alignas(64) atomic<uint32_t> tail; // written by the receiver
+    alignas(64) atomic<uint32_t> receiverSleeping; // receiver is (about to be) in futex wait on head
+    atomic<uint32_t> senderSleeping; // sender is (about to be) in futex wait on tail
+    MessageRecord records[RING_SLOTS];
+};
+
+struct SharedSegment
+{
+    atomic<uint32_t> closed; // set when either side disconnects
+    atomic<int32_t> pids[2]; // process id of each side, 0 until that side has mapped the segment
+    MessageRing rings[2]; // rings[i] carries messages sent by side i
+};
+
+namespace
+{
+#ifdef __linux__
+/**
+ * @brief Sleeps until the word changes from `expected`, a wake-up arrives, or 100 ms pass.
+ */
+void futexWait(atomic<uint32_t> &word, uint32_t expected)
+{
+    timespec timeout = {0, 100000000};
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+/**
+ * @brief Wakes every process sleeping on the word.
+ */
+void futexWake(atomic<uint32_t> &word)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+/**
+ * @brief Hints to the CPU that this is a spin-wait loop.
+ */
+void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+#endif
+}
+
+/**
+ * @brief Sends a null-terminated message over the socket.
+ */
+bool TcpTransport::sendMessage(const string &message)
+{
+    if (socket.send(message.c_str(), message.size() + 1) != Socket::Done)
+        return false;
+    countMetric(NETWORK_MESSAGES_SENT);
+    countMetric(NETWORK_BYTES_SENT, message.size() + 1);
+    return true;
+}
+
+/**
+ * @brief Receives a null-terminated message from the socket.
+ *
+ * TCP may deliver several messages in one read or split one across reads, so bytes past the
+ * terminator are kept for the next call.
+ */
+bool TcpTransport::receiveMessage(string &message)
+{
+    size_t end;
+    while ((end = buffered.find('\0')) == string::npos)
+    {
+        char buffer[1024];
+        size_t received;
+        if (socket.receive(buffer, sizeof(buffer), received) != Socket::Done)
+            return false;
+        countMetric(NETWORK_BYTES_RECEIVED, received);
+        buffered.append(buffer, received);
+    }
+    message = buffered.substr(0, end);
+    buffered.erase(0, end + 1);
+    countMetric(NETWORK_MESSAGES_RECEIVED);
+    return true;
+}
+
+/**
+ * @brief Checks whether this platform supports the shared-memory transport (Linux only).
+ */
+bool SharedMemoryTransport::isSupported()
+{
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+SharedMemoryTransport::SharedMemoryTransport(SharedSegment *segment, const string &name, int side)
+    : segment(segment), segmentName(name), side(side)
+{
+}
+
+/**
+ * @brief Creates a new shared-memory segment for the server side.
+ *
+ * @return The transport, or null if the segment could not be created.
+ */
+unique_ptr<SharedMemoryTransport> SharedMemoryTransport::create()
+{
+#ifdef __linux__
+    string name = "/tictactoe-" + to_string(PORT) + "-" + to_string(random_device{}());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+        return nullptr;
+    if (ftruncate(fd, sizeof(SharedSegment)) != 0)
+    {
+        close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    void *memory = mmap(nullptr, sizeof(SharedSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED)
+    {
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    SharedSegment *segment = new (memory) SharedSegment();
+    segment->pids[0].store(getpid());
+    return unique_ptr<SharedMemoryTransport>(new SharedMemoryTransport(segment, name, 0));
+#else
+    return nullptr;
+#endif
+}
+
+/**
+ * @brief Maps a segment created by the server, for the client side.
+ *
+ * @param name The segment name the server advertised.
+ * @return The transport, or null if the segment could not be mapped.
+ */
+unique_ptr<SharedMemoryTransport> SharedMemoryTransport::attach(const string &name)
+{
+#ifdef __linux__
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0)
+        return nullptr;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size != static_cast<off_t>(sizeof(SharedSegment)))
+    {
+        close(fd);
+        return nullptr;
+    }
+    void *memory = mmap(nullptr, sizeof(SharedSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED)
+        return nullptr;
+    SharedSegment *segment = static_cast<SharedSegment *>(memory);
+    segment->pids[1].store(getpid());
+    return unique_ptr<SharedMemoryTransport>(new SharedMemoryTransport(segment, name, 1));
+#else
+    (void)name;
+    return nullptr;
+#endif
+}
+
+/**
+ * @brief Marks the segment closed, wakes the peer, and unmaps the segment.
+ */
+SharedMemoryTransport::~SharedMemoryTransport()
+{
+#ifdef __linux__
+    segment->closed.store(1);
+    for (MessageRing &ring : segment->rings)
+    {
+        futexWake(ring.head);
+        futexWake(ring.tail);
+    }
+    if (side == 0)
+        unlink();
+    munmap(segment, sizeof(SharedSegment));
+#endif
+}
+
+/**
+ * @brief Removes the segment's name so it disappears once both sides unmap it.
+ */
+void SharedMemoryTransport::unlink()
+{
+#ifdef __linux__
+    if (!segmentName.empty())
+    {
+        shm_unlink(segmentName.c_str());
+        segmentName.clear();
+    }
+#endif
+}
+
+/**
+ * @brief Checks whether the peer has disconnected, marking the segment closed if its process has
+ *        exited without doing so (crashed or killed).
+ */
+bool SharedMemoryTransport::peerGone()
+{
+#ifdef __linux__
+    if (segment->closed.load())
+        return true;
+    pid_t peer = segment->pids[side ^ 1].load();
+    if (peer != 0 && kill(peer, 0) != 0 && errno == ESRCH)
+    {
+        segment->closed.store(1);
+        return true;
+    }
+#endif
+    return false;
+}
+
+/**
+ * @brief Writes a message into the next free record of this side's ring.
+ *
+ * @return False if the message does not fit in a record or the peer has disconnected.
+ */
+bool SharedMemoryTransport::sendMessage(const string &message)
+{
+#ifdef __linux__
+    MessageRing &ring = segment->rings[side];
+    if (message.size() >= sizeof(MessageRecord::data))
+        return false;
+
+    // Wait for a free record (the peer is at most RING_SLOTS messages behind)
+    uint32_t head = ring.head.load(memory_order_relaxed);
+    for (int spin = 0; head - ring.tail.load(memory_order_acquire) >= RING_SLOTS; ++spin)
+    {
+        if (segment->closed.load())
+            return false;
+        if (spin < spinLimit())
+        {
+            cpuRelax();
+            continue;
+        }
+        ring.senderSleeping.store(1);
+        uint32_t tail = ring.tail.load();
+        if (head - tail >= RING_SLOTS)
+            futexWait(ring.tail, tail);
+        ring.senderSleeping.store(0);
+        if (ring.tail.load() == tail && peerGone())
+            return false;
+    }
+
+    MessageRecord &record = ring.records[head % RING_SLOTS];
+    memcpy(record.data, message.data(), message.size());
+    record.data[message.size()] = '\0';
+    record.length = static_cast<uint32_t>(message.size());
+    ring.head.store(head + 1);
+
+    if (ring.receiverSleeping.load())
+        futexWake(ring.head);
+    countMetric(NETWORK_MESSAGES_SENT);
+    countMetric(NETWORK_BYTES_SENT, sizeof(uint32_t) + message.size() + 1);
+    return true;
+#else
+    (void)message;
+    return false;
+#endif
+}
+
+/**
+ * @brief Waits for and reads the next record of the peer's ring.
+ *
+ * @return False if the peer disconnected before sending a message.
+ */
+bool SharedMemoryTransport::receiveMessage(string &message)
+{
+#ifdef __linux__
+    MessageRing &ring = segment->rings[side ^ 1];
+    uint32_t tail = ring.tail.load(memory_order_relaxed);
+
+    for (int spin = 0; ring.head.load(memory_order_acquire) == tail; ++spin)
+    {
+        if (segment->closed.load())
+            return false;
+        if (spin < spinLimit())
+        {
+            cpuRelax();
+            continue;
+        }
+        ring.receiverSleeping.store(1);
+        if (ring.head.load() == tail)
+            futexWait(ring.head, tail);
+        ring.receiverSleeping.store(0);
+        if (ring.head.load() == tail && peerGone())
+            return false;
+    }
+
+    const MessageRecord &record = ring.records[tail % RING_SLOTS];
+    message.assign(record.data, record.length);
+    ring.tail.store(tail + 1);
+
+    if (ring.senderSleeping.load())
+        futexWake(ring.tail);
+    countMetric(NETWORK_MESSAGES_RECEIVED);
+    countMetric(NETWORK_BYTES_RECEIVED, sizeof(uint32_t) + record.length + 1);
+    return true;
+#else
+    (void)message;
+    return false;
+#endif
+}
+
+
+/**
+ * @brief Datagram link over a UDP socket to one peer.
+ */
+class UdpLink : public DatagramLink
+{
+public:
+    UdpSocket socket;
+    IpAddress peerAddress;
+    unsigned short peerPort = 0;
+
+    UdpLink() : buffer(UdpSocket::MaxDatagramSize) { selector.add(socket); }
+
+    bool sendDatagram(const string &datagram) override
+    {
+        if (socket.send(datagram.data(), datagram.size(), peerAddress, peerPort) != Socket::Done)
+            return false;
+        countMetric(NETWORK_BYTES_SENT, datagram.size());
+        return true;
+    }
+
+    bool receiveDatagram(string &datagram, uint64_t timeoutMicros) override
+    {
+        // A zero timeout would make the selector wait forever
+        if (!selector.wait(microseconds(static_cast<Int64>(max<uint64_t>(timeoutMicros, 1)))))
+            return false;
+        size_t received;
+        IpAddress sender;
+        unsigned short senderPort;
+        if (socket.receive(buffer.data(), buffer.size(), received, sender, senderPort) != Socket::Done ||
+            sender != peerAddress || senderPort != peerPort)
+            return false; // errors and strays look like lost datagrams to the channel
+        countMetric(NETWORK_BYTES_RECEIVED, received);
+        datagram.assign(buffer.data(), received);
+        return true;
+    }
+
+private:
+    SocketSelector selector;
+    vector<char> buffer;
+};
+
+/**
+ * @brief Binds a UDP socket on any free port; the channel starts when connect() names the peer.
+ *
+ * @return The transport, or null if no port could be bound.
+ */
+unique_ptr<UdpTransport> UdpTransport::bind()
+{
+    unique_ptr<UdpLink> link(new UdpLink());
+    if (link->socket.bind(Socket::AnyPort) != Socket::Done)
+        return nullptr;
+    return unique_ptr<UdpTransport>(new UdpTransport(move(link)));
+}
+
+UdpTransport::UdpTransport(unique_ptr<UdpLink> link) : link(move(link))
+{
+}
+
+UdpTransport::~UdpTransport()
+{
+    channel.reset(); // stop the worker before the socket goes away
+}
+
+/**
+ * @brief Sets the peer's address and starts the reliable channel.
+ */
+void UdpTransport::connect(const IpAddress &address, unsigned short port)
+{
+    link->peerAddress = address;
+    link->peerPort = port;
+    channel.reset(new ReliableChannel(*link));
+}
+
+unsigned short UdpTransport::getLocalPort() const
+{
+    return link->socket.getLocalPort();
+}
+
+/**
+ * @brief Sends a message through the reliable channel.
+ */
+bool UdpTransport::sendMessage(const string &message)
+{
+    if (!channel || !channel->send(message))
+        return false;
+    countMetric(NETWORK_MESSAGES_SENT);
+    return true;
+}
+
+/**
+ * @brief Receives the next message to arrive, which may overtake one sent before it.
+ *
+ * @return False once the peer has stopped responding.
+ */
+bool UdpTransport::receiveMessage(string &message)
+{
+    if (!channel || !channel->receive(message))
+        return false;
+    countMetric(NETWORK_MESSAGES_RECEIVED);
+    return true;
+}
@@ -0,0 +1,363 @@
+/*
+Author: Arina Shah
+Class: ECE4122 (A)
+Last Date Modified: 10/19/2026
+Description:
+This file implements the Ultimate Tic Tac Toe rules on bitboards and the Monte Carlo tree search
+engine for the computer player. Legal moves come straight from the sub-board masks selected by the
+previous move, and playouts run entirely on the packed board with no allocation, which is what
+lets the engine run tens of thousands of playouts per move despite the large branching factor.
+*/
+
+#include "ultimate.hpp"
+#include "ai.hpp"
+#include "metrics.hpp"
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+// The eight winning lines of a 3x3 board as 9-bit masks (bit = row * 3 + col)
+const uint16_t LINE_MASKS[8] = {0x007, 0x038, 0x1C0, 0x049, 0x092, 0x124, 0x111, 0x054};
+const uint16_t FULL_MASK = 0x1FF;
+
+/**
+ * @brief Lookup table telling whether each of the 512 possible 3x3 masks contains a line.
+ */
+struct WinTable
+{
+    bool wins[512];
+
+    WinTable()
+    {
+        for (int mask = 0; mask < 512; ++mask)
+        {
+            wins[mask] = false;
+            for (uint16_t line : LINE_MASKS)
+            {
+                if ((mask & line) == line)
+                    wins[mask] = true;
+            }
+        }
+    }
+};
+
+const WinTable winTable;
+
+/**
+ * @brief Small xorshift64* generator for playouts.
+ */
+struct Random
+{
+    uint64_t state;
+
+    uint32_t next()
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return static_cast<uint32_t>((state * 0x2545F4914F6CDD1DULL) >> 32);
+    }
+};
+
+struct MctsNode
+{
+    int firstChild = -1; // index of the first child in the tree, -1 if not expanded
+    int childCount = 0; // number of children
+    int move = -1; // move that leads to this node
+    uint32_t visits = 0; // playouts through this node
+    float score = 0; // wins (1) and draws (0.5) for the player who made `move`
+};
+
+/**
+ * @brief Plays random legal moves until the game ends.
+ * @return 0 if X wins, 1 if O wins, -1 for a draw.
+ */
+int playout(UltimateBoard state, Random &random)
+{
+    int moves[81];
+    while (state.status == PLAYING)
+    {
+        int count = state.legalMoves(moves);
+        state.play(moves[random.next() % count]);
+    }
+    if (state.status == X_WIN)
+        return 0;
+    if (state.status == O_WIN)
+        return 1;
+    return -1;
+}
+}
+
+/**
+ * @brief Builds the bitboard position from a game in the ULTIMATE variant.
+ *
+ * @param game The game state. Its last move decides which sub-board is played next.
+ * @return The packed position.
+ */
+UltimateBoard UltimateBoard::fromGame(const Game &game)
+{
+    UltimateBoard board = {};
+    for (int row = 0; row < 9; ++row)
+    {
+        for (int col = 0; col < 9; ++col)
+        {
+            if (game.grid[row][col] == 0)
+                continue;
+            int move = ultimateMoveIndex(row, col);
+            board.cells[game.grid[row][col] - 1][move / 9] |= 1 << (move % 9);
+        }
+    }
+
+    for (int sub = 0; sub < 9; ++sub)
+    {
+        if (winTable.wins[board.cells[0][sub]])
+            board.won[0] |= 1 << sub;
+        else if (winTable.wins[board.cells[1][sub]])
+            board.won[1] |= 1 << sub;
+        if ((board.won[0] | board.won[1]) & (1 << sub) || (board.cells[0][sub] | board.cells[1][sub]) == FULL_MASK)
+            board.closed |= 1 << sub;
+    }
+
+    if (winTable.wins[board.won[0]])
+        board.status = X_WIN;
+    else if (winTable.wins[board.won[1]])
+        board.status = O_WIN;
+    else if (board.closed == FULL_MASK)
+        board.status = DRAW;
+    else
+        board.status = PLAYING;
+
+    board.forcedBoard = -1;
+    if (game.lastMove.first >= 0)
+    {
+        int target = ultimateMoveIndex(game.lastMove.first, game.lastMove.second) % 9;
+        if (!(board.closed & (1 << target)))
+            board.forcedBoard = target;
+    }
+    board.toMove = game.activeTurn == X ? 0 : 1;
+    return board;
+}
+
+/**
+ * @brief Lists the legal moves of the player to move.
+ *
+ * @param moves Receives up to 81 moves (board * 9 + cell).
+ * @return The number of legal moves.
+ */
+int UltimateBoard::legalMoves(int *moves) const
+{
+    int count = 0;
+    uint16_t boards = forcedBoard >= 0 ? (1 << forcedBoard) : (~closed & FULL_MASK);
+    for (int sub = 0; sub < 9; ++sub)
+    {
+        if (!(boards & (1 << sub)))
+            continue;
+        uint16_t empty = ~(cells[0][sub] | cells[1][sub]) & FULL_MASK;
+        for (int cell = 0; cell < 9; ++cell)
+        {
+            if (empty & (1 << cell))
+                moves[count++] = sub * 9 + cell;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Checks whether the player to move may play a move.
+ */
+bool UltimateBoard::isLegal(int move) const
+{
+    int sub = move / 9, cell = move % 9;
+    if (status != PLAYING || (closed & (1 << sub)))
+        return false;
+    if (forcedBoard >= 0 && forcedBoard != sub)
+        return false;
+    return !((cells[0][sub] | cells[1][sub]) & (1 << cell));
+}
+
+/**
+ * @brief Plays a legal move for the player to move and updates the sub-board and game outcome.
+ */
+void UltimateBoard::play(int move)
+{
+    int sub = move / 9, cell = move % 9;
+    uint16_t &own = cells[toMove][sub];
+    own |= 1 << cell;
+
+    if (winTable.wins[own])
+    {
+        won[toMove] |= 1 << sub;
+        closed |= 1 << sub;
+        if (winTable.wins[won[toMove]])
+            status = toMove == 0 ? X_WIN : O_WIN;
+    }
+    else if ((own | cells[toMove ^ 1][sub]) == FULL_MASK)
+    {
+        closed |= 1 << sub;
+    }
+    if (status == PLAYING && closed == FULL_MASK)
+        status = DRAW;
+
+    forcedBoard = (closed & (1 << cell)) ? -1 : cell;
+    toMove ^= 1;
+}
+
+/**
+ * @brief Converts a grid cell of the 9x9 board to a move number (board * 9 + cell).
+ */
+int ultimateMoveIndex(int row, int col)
+{
+    return ((row / 3) * 3 + col / 3) * 9 + (row % 3) * 3 + col % 3;
+}
+
+/**
+ * @brief Converts a move number (board * 9 + cell) to its grid row and column.
+ */
+pair<int, int> ultimateMoveCell(int move)
+{
+    int sub = move / 9, cell = move % 9;
+    return {(sub / 3) * 3 + cell / 3, (sub % 3) * 3 + cell % 3};
+}
+
+/**
+ * @brief Runs Monte Carlo tree search (UCT with random playouts) from a position.
+ *
+ * @param board The position to search. It must still be in play.
+ * @param limits Playout, time and tree size budgets and the exploration constant.
+ * @return The most visited root move and search statistics. A move that wins the game
+ *         immediately is returned without searching.
+ */
+MctsResult searchUltimate(const UltimateBoard &board, const MctsLimits &limits)
+{
+    MctsResult result;
+    auto start = chrono::steady_clock::now();
+
+    int rootMoves[81];
+    int rootCount = board.legalMoves(rootMoves);
+    for (int i = 0; i < rootCount; ++i)
+    {
+        UltimateBoard next = board;
+        next.play(rootMoves[i]);
+        if (next.status == (board.toMove == 0 ? X_WIN : O_WIN))
+        {
+            result.move = rootMoves[i];
+            result.winRate = 1;
+            return result;
+        }
+    }
+
+    vector<MctsNode> tree;
+    tree.reserve(min<size_t>(limits.maxNodes, 1 << 16));
+    tree.emplace_back();
+    tree[0].firstChild = 1;
+    tree[0].childCount = rootCount;
+    for (int i = 0; i < rootCount; ++i)
+    {
+        tree.emplace_back();
+        tree.back().move = rootMoves[i];
+    }
+
+    Random random{0x9E3779B97F4A7C15ULL ^ static_cast<uint64_t>(start.time_since_epoch().count())};
+    vector<int> path;
+    int moves[81];
+
+    while (result.playouts < limits.maxPlayouts)
+    {
+        if ((result.playouts & 255) == 0 &&
+            (chrono::duration<double>(chrono::steady_clock::now() - start).count() > limits.maxSeconds ||
+             (limits.stop && limits.stop->load(memory_order_relaxed))))
+            break;
+
+        // Selection: follow the child with the best UCT value down to a leaf
+        UltimateBoard state = board;
+        int node = 0;
+        path.assign(1, 0);
+        while (tree[node].childCount > 0 && state.status == PLAYING)
+        {
+            double logVisits = log(static_cast<double>(tree[node].visits) + 1);
+            int best = tree[node].firstChild;
+            double bestValue = -1;
+            for (int child = tree[node].firstChild; child < tree[node].firstChild + tree[node].childCount; ++child)
+            {
+                if (tree[child].visits == 0)
+                {
+                    best = child;
+                    break;
+                }
+                double value = tree[child].score / tree[child].visits +
+                               limits.exploration * sqrt(logVisits / tree[child].visits);
+                if (value > bestValue)
+                {
+                    bestValue = value;
+                    best = child;
+                }
+            }
+            node = best;
+            state.play(tree[node].move);
+            path.push_back(node);
+        }
+
+        // Expansion: a leaf that has already been visited once gets its children
+        if (state.status == PLAYING && tree[node].visits > 0 && tree.size() + 81 <= limits.maxNodes)
+        {
+            int count = state.legalMoves(moves);
+            tree[node].firstChild = static_cast<int>(tree.size());
+            tree[node].childCount = count;
+            for (int i = 0; i < count; ++i)
+            {
+                tree.emplace_back();
+                tree.back().move = moves[i];
+            }
+            node = tree[node].firstChild;
+            state.play(tree[node].move);
+            path.push_back(node);
+        }
+
+        // Simulation and backpropagation; the node at depth d was reached by a move of player (toMove + d - 1)
+        int winner = playout(state, random);
+        for (size_t depth = 0; depth < path.size(); ++depth)
+        {
+            MctsNode &pathNode = tree[path[depth]];
+            int mover = (board.toMove + static_cast<int>(depth) + 1) % 2;
+            pathNode.visits++;
+            if (winner == mover)
+                pathNode.score += 1;
+            else if (winner < 0)
+                pathNode.score += 0.5f;
+        }
+        result.playouts++;
+    }
+
+    // Play the most visited root move
+    int best = tree[0].firstChild;
+    for (int child = tree[0].firstChild; child < tree[0].firstChild + tree[0].childCount; ++child)
+    {
+        if (tree[child].visits > tree[best].visits)
+            best = child;
+    }
+    result.move = tree[best].move;
+    result.winRate = tree[best].visits > 0 ? tree[best].score / tree[best].visits : 0;
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+/**
+ * @brief Chooses the computer's move in the ULTIMATE variant.
+ *
+ * @param game The current game state.
+ * @param limits Search budgets for the move.
+ * @return The row and column of the chosen move on the 9x9 grid.
+ */
+pair<int, int> ultimateMove(const Game &game, const MctsLimits &limits)
+{
+    MctsResult result = searchUltimate(UltimateBoard::fromGame(game), limits);
+    countMetric(MCTS_PLAYOUTS, result.playouts);
+    if (logEngineStats)
+    {
+        cout << "MCTS: " << result.playouts << " playouts in " << result.seconds * 1000 << " ms ("
+             << static_cast<uint64_t>(result.seconds > 0 ? result.playouts / result.seconds : 0)
+             << " playouts/sec, win rate " << result.winRate << ")" << endl;
+    }
+    return ultimateMoveCell(result.move);
+}